@@ -203,15 +203,23 @@ const constexpr GlyphCode SPACE_CODE    = 0x7FFE;
 // to be processed through the RLEExtractor class.
 // Dim contains the expected width and height once the bitmap has been
 // decompressed. The length is the pixels array size in bytes.
+// The pixels are a view on memory owned by the font: the font file content
+// or the pixels pool generated at save time.
 
 struct RLEBitmap {
-  Pixels   pixels;
-  Dim      dim;
-  uint16_t length;
-  void     clear() {
-        pixels.clear();
-        dim    = Dim(0, 0);
-        length = 0;
+  const uint8_t *pixels;
+  Dim            dim;
+  uint16_t       length;
+  RLEBitmap() { clear(); }
+  RLEBitmap(const uint8_t *thePixels, uint16_t theLength, Dim theDim) {
+    pixels = thePixels;
+    dim    = theDim;
+    length = theLength;
+  }
+  void clear() {
+    pixels = nullptr;
+    dim    = Dim(0, 0);
+    length = 0;
   }
 };
 typedef std::shared_ptr<RLEBitmap> RLEBitmapPtr;
@@ -231,14 +239,11 @@ struct Bitmap {
     dim    = theDim;
   }
   bool operator==(const Bitmap &other) const {
-    if ((pixels.size() != other.pixels.size()) || !(dim == other.dim)) return false;
-    for (int idx = 0; idx < pixels.size(); idx++) {
-      if (pixels.at(idx) != other.pixels.at(idx)) return false;
-    }
-    return true;
+    return (dim == other.dim) && (pixels == other.pixels); // memcmp of the pixels
   }
 };
-typedef std::shared_ptr<Bitmap> BitmapPtr;
+typedef std::shared_ptr<Bitmap>       BitmapPtr;
+typedef std::shared_ptr<const Bitmap> BitmapConstPtr;
 
 #pragma pack(push, 1)
 
@@ -547,7 +552,8 @@ struct GlyphLigKern {
     return true;
   }
 };
-typedef std::shared_ptr<GlyphLigKern> GlyphLigKernPtr;
+typedef std::shared_ptr<GlyphLigKern>       GlyphLigKernPtr;
+typedef std::shared_ptr<const GlyphLigKern> GlyphLigKernConstPtr;
 
 #pragma pack(push, 1)
 struct BackupGlyphKernStep {
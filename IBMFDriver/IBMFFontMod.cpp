@@ -1,35 +1,212 @@
 #include "IBMFFontMod.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <numeric>
+#include <thread>
 
+#include <QFileInfo>
 #include <QIODevice>
 #include <QMessageBox>
 
-void IBMFFontMod::clear() {
-  initialized_ = false;
+IBMFFontMod::IBMFFontMod(const QString &filePath) : memory_(nullptr), memoryLength_(0) {
+  mappedFile_.setFileName(filePath);
+  if (mappedFile_.open(QIODevice::ReadOnly)) {
+    memoryLength_ = mappedFile_.size();
+    memory_       = mappedFile_.map(0, memoryLength_);
+    // The mapping stays valid until unmapped by releaseFile() or mappedFile_ is destroyed
+    mappedFile_.close();
+  }
+  initialized_ = (memory_ != nullptr) && load();
+  lastError_   = 0;
+}
+
+/// @brief Take a snapshot of a font, to be saved without blocking the font
+///
+/// The snapshot owns a copy of the faces of the font. The font can then be modified while
+/// the snapshot is being saved, saving the snapshot having no effect on the font either.
+///
+/// Only the glyph metrics, rewritten by the save, are copied. The pixels pools, bitmaps and
+/// lig/kern programs are shared: the font never modifies them in place, but replaces them.
+/// The pools still located in the font file are used through the font, kept alive by the
+/// snapshot. If the snapshot is to replace that file, the font first releases it (see
+/// releaseFile()).
+///
+/// @param font The font to take a snapshot of.
+/// @param filePath The file the snapshot will be saved to.
+/// @return The snapshot.
+auto IBMFFontMod::snapshotOf(IBMFFontModPtr font, const QString &filePath) -> IBMFFontModPtr {
+  IBMFFontModPtr snapshot = IBMFFontModPtr(new IBMFFontMod());
+
+  if (!filePath.isEmpty() && !font->mappedFile_.fileName().isEmpty() &&
+      (QFileInfo(font->mappedFile_.fileName()) == QFileInfo(filePath))) {
+    font->releaseFile();
+  }
+
+  snapshot->source_                = font;
+  snapshot->modificationCount_     = font->modificationCount_;
+  snapshot->preamble_              = font->preamble_;
+  snapshot->planes_                = font->planes_;
+  snapshot->codePointBundles_      = font->codePointBundles_;
+  snapshot->bundlesFirstGlyphCode_ = font->bundlesFirstGlyphCode_;
+  snapshot->bmpGlyphCodes_         = font->bmpGlyphCodes_;
+  snapshot->glyphCodePoints_       = font->glyphCodePoints_;
+  snapshot->faceOffsets_           = font->faceOffsets_;
+  snapshot->initialized_           = font->initialized_;
+  snapshot->lastError_             = 0;
+
+  for (auto &face : font->faces_) {
+    FacePtr newFace = std::make_shared<Face>(*face);
+    newFace->header = std::make_shared<FaceHeader>(*face->header);
+    for (auto &glyph : newFace->backupGlyphs) {
+      glyph = std::make_shared<BackupGlyphInfo>(*glyph);
+    }
+    snapshot->faces_.push_back(newFace);
+  }
+
+  return snapshot;
+}
+
+/// @brief Update the font with the outcome of the save of a snapshot taken from it
+///
+/// The font becomes as if it had been saved itself: its faces get the headers, glyph
+/// metrics, pixels pools and lig/kern steps generated by the save. If the font was modified
+/// since the snapshot was taken, it is left as is: the saved content would overwrite the
+/// changes, and the modified glyphs must remain so to be encoded by the next save.
+///
+/// @param snapshot The snapshot, successfully saved.
+/// @param filePath The file the snapshot was saved to, if any. The font then accesses the
+///                 pools from it, instead of keeping them in memory (see mapSavedFile()).
+/// @return true if the font is now in the saved state, false if it was modified meanwhile.
+auto IBMFFontMod::snapshotSaved(IBMFFontModPtr snapshot, const QString &filePath) -> bool {
+  if ((snapshot->source_.get() != this) || (snapshot->faces_.size() != faces_.size()) ||
+      (snapshot->modificationCount_ != modificationCount_)) {
+    return false;
+  }
+
+  for (int faceIdx = 0; faceIdx < faces_.size(); faceIdx++) {
+    Face &face  = *faces_[faceIdx];
+    Face &saved = *snapshot->faces_[faceIdx];
+
+    *face.header = *saved.header;
+    face.glyphs  = saved.glyphs;
+    for (int idx = 0; idx < face.backupGlyphs.size(); idx++) {
+      *face.backupGlyphs[idx] = *saved.backupGlyphs[idx];
+    }
+    face.savedPixelsPool    = saved.savedPixelsPool;
+    face.savedPixelsPoolPos = saved.savedPixelsPoolPos;
+    face.pixelsPool         = saved.pixelsPool;
+    face.pixelsPoolIndexes  = std::move(saved.pixelsPoolIndexes);
+    face.ligKernSteps       = std::move(saved.ligKernSteps);
+    face.fingerprints.clear(); // The glyphs RLE metrics changed
+  }
+
+  // No pool is located in the previous file anymore
+  releaseFile();
+  if (!filePath.isEmpty()) mapSavedFile(filePath);
+
+  return true;
+}
+
+/// @brief Access the pixels pools of the faces from the file the font was just saved to
+///
+/// The pools generated by the save are freed, the file being memory mapped in their place
+/// as when a font is opened. If the file content doesn't match, the pools are kept.
+///
+/// @param filePath The file written by the last save of the font.
+auto IBMFFontMod::mapSavedFile(const QString &filePath) -> void {
+  mappedFile_.setFileName(filePath);
+  if (!mappedFile_.open(QIODevice::ReadOnly)) return;
+  uint32_t length = mappedFile_.size();
+  uint8_t *memory = mappedFile_.map(0, length);
+  mappedFile_.close();
+  if (memory == nullptr) return;
+
   for (auto &face : faces_) {
-    for (auto bitmap : face->bitmaps) {
-      bitmap->clear();
+    if ((face->savedPixelsPool == nullptr) ||
+        (face->savedPixelsPoolPos + face->savedPixelsPool->size() > length) ||
+        (memcmp(&memory[face->savedPixelsPoolPos], face->savedPixelsPool->data(),
+                face->savedPixelsPool->size()) != 0)) {
+      mappedFile_.unmap(memory);
+      return;
     }
-    for (auto bitmap : face->compressedBitmaps) {
-      bitmap->clear();
+  }
+
+  memory_       = memory;
+  memoryLength_ = length;
+  for (auto &face : faces_) {
+    face->pixelsPool = &memory_[face->savedPixelsPoolPos];
+    face->savedPixelsPool.reset();
+  }
+}
+
+/// @brief Stop accessing the content of the font file, the pixels pools being copied
+///
+/// A file cannot be replaced while it is memory mapped on some systems (Windows): saving
+/// the font over its own file, through a QSaveFile rename, would fail. The pools still
+/// located in the file content are then copied, and the file unmapped.
+auto IBMFFontMod::releaseFile() -> void {
+  if (memory_ == nullptr) return;
+
+  for (auto &face : faces_) {
+    if ((face->pixelsPool == nullptr) || (face->savedPixelsPool != nullptr)) continue;
+
+    // The header pixelsPoolSize may have been edited: the pool extent is computed from the
+    // packets still located in it.
+    size_t poolSize = 0;
+    for (int idx = 0; idx < face->pixelsPoolIndexes.size(); idx++) {
+      if (face->pixelsPoolIndexes[idx] == MODIFIED_BITMAP) continue;
+      size_t length = (preamble_.bits.fontFormat == FontFormat::BACKUP)
+                          ? face->backupGlyphs[idx]->packetLength
+                          : face->glyphs[idx].packetLength;
+      poolSize      = std::max(poolSize, face->pixelsPoolIndexes[idx] + length);
     }
+    face->savedPixelsPool =
+        std::make_shared<const Pixels>(face->pixelsPool, face->pixelsPool + poolSize);
+    face->pixelsPool = face->savedPixelsPool->data();
+  }
+
+  if (mappedFile_.fileName().isEmpty()) {
+    memoryContent_.clear();
+    memoryContent_.shrink_to_fit();
+  } else {
+    mappedFile_.unmap(memory_);
+  }
+  memory_       = nullptr;
+  memoryLength_ = 0;
+}
+
+void IBMFFontMod::clear() {
+  modificationCount_++;
+  initialized_ = false;
+  for (auto &face : faces_) {
     face->glyphs.clear();
     face->backupGlyphs.clear();
+    face->backupGlyphIndexes.clear();
     face->bitmaps.clear();
-    face->compressedBitmaps.clear();
+    face->pixelsPoolIndexes.clear();
+    face->savedPixelsPool.reset();
+    face->pixelsPool = nullptr;
     face->glyphsLigKern.clear();
     face->ligKernSteps.clear();
+    face->fingerprints.clear();
   }
   faces_.clear();
+  decodedBitmaps_.clear();
   faceOffsets_.clear();
   planes_.clear();
   codePointBundles_.clear();
+  bundlesFirstGlyphCode_.clear();
+  bmpGlyphCodes_.clear();
+  glyphCodePoints_.clear();
 }
 
 bool IBMFFontMod::load() {
+  if (memoryLength_ < sizeof(Preamble)) return false;
+
   // Preamble retrieval
   memcpy(&preamble_, memory_, sizeof(Preamble));
   if (strncmp("IBMF", preamble_.marker, 4) != 0) return false;
@@ -60,6 +237,8 @@ bool IBMFFontMod::load() {
     }
     idx +=
         (((*planes)[3].codePointBundlesIdx + (*planes)[3].entriesCount) * sizeof(CodePointBundle));
+
+    buildCodePointIndex();
   } else {
     planes_.clear();
     codePointBundles_.clear();
@@ -82,80 +261,38 @@ bool IBMFFontMod::load() {
     glyphsPixelPoolIndexes = reinterpret_cast<GlyphsPixelPoolIndexesTempPtr>(&memory_[idx]);
     idx += (sizeof(PixelPoolIndex) * header->glyphCount);
 
-    // Glyphs info and bitmaps
+    // Glyphs info. The bitmaps will be retrieved on first access (see getBitmap())
 
     if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
       pixelsPool = reinterpret_cast<PixelsPoolTempPtr>(
           &memory_[idx + (sizeof(BackupGlyphInfo) * header->glyphCount)]);
 
       face->backupGlyphs.reserve(header->glyphCount);
+      face->backupGlyphIndexes.reserve(header->glyphCount);
 
       for (int glyphCode = 0; glyphCode < header->glyphCount; glyphCode++) {
         BackupGlyphInfoPtr backupGlyphInfo = BackupGlyphInfoPtr(new BackupGlyphInfo);
         memcpy(backupGlyphInfo.get(), &memory_[idx], sizeof(BackupGlyphInfo));
         idx += sizeof(BackupGlyphInfo);
 
-        int       bitmap_size = backupGlyphInfo->bitmapHeight * backupGlyphInfo->bitmapWidth;
-        BitmapPtr bitmap      = BitmapPtr(new Bitmap);
-        bitmap->pixels        = Pixels(bitmap_size, 0);
-        bitmap->dim           = Dim(backupGlyphInfo->bitmapWidth, backupGlyphInfo->bitmapHeight);
-
-        RLEBitmapPtr compressedBitmap = RLEBitmapPtr(new RLEBitmap);
-        compressedBitmap->dim         = bitmap->dim;
-        compressedBitmap->pixels.reserve(backupGlyphInfo->packetLength);
-        compressedBitmap->length = backupGlyphInfo->packetLength;
-        for (int pos = 0; pos < backupGlyphInfo->packetLength; pos++) {
-          compressedBitmap->pixels.push_back(
-              (*pixelsPool)[pos + (*glyphsPixelPoolIndexes)[glyphCode]]);
-        }
-
-        RLEExtractor rle;
-        rle.retrieveBitmap(*compressedBitmap, *bitmap, Pos(0, 0), backupGlyphInfo->rleMetrics);
-        // retrieveBitmap(idx, glyphInfo.get(), *bitmap, Pos(0,0));
-
+        // If a code point is present more than once, the first one is found
+        face->backupGlyphIndexes.emplace(backupGlyphInfo->codePoint, glyphCode);
         face->backupGlyphs.push_back(backupGlyphInfo);
-        face->bitmaps.push_back(bitmap);
-        face->compressedBitmaps.push_back(compressedBitmap);
-
-        // idx += glyphInfo->packetLength;
       }
     } else {
       pixelsPool = reinterpret_cast<PixelsPoolTempPtr>(
           &memory_[idx + (sizeof(GlyphInfo) * header->glyphCount)]);
 
-      face->glyphs.reserve(header->glyphCount);
-
-      for (int glyphCode = 0; glyphCode < header->glyphCount; glyphCode++) {
-        GlyphInfoPtr glyphInfo = GlyphInfoPtr(new GlyphInfo);
-        memcpy(glyphInfo.get(), &memory_[idx], sizeof(GlyphInfo));
-        idx += sizeof(GlyphInfo);
-
-        int       bitmap_size         = glyphInfo->bitmapHeight * glyphInfo->bitmapWidth;
-        BitmapPtr bitmap              = BitmapPtr(new Bitmap);
-        bitmap->pixels                = Pixels(bitmap_size, 0);
-        bitmap->dim                   = Dim(glyphInfo->bitmapWidth, glyphInfo->bitmapHeight);
-
-        RLEBitmapPtr compressedBitmap = RLEBitmapPtr(new RLEBitmap);
-        compressedBitmap->dim         = bitmap->dim;
-        compressedBitmap->pixels.reserve(glyphInfo->packetLength);
-        compressedBitmap->length = glyphInfo->packetLength;
-        for (int pos = 0; pos < glyphInfo->packetLength; pos++) {
-          compressedBitmap->pixels.push_back(
-              (*pixelsPool)[pos + (*glyphsPixelPoolIndexes)[glyphCode]]);
-        }
-
-        RLEExtractor rle;
-        rle.retrieveBitmap(*compressedBitmap, *bitmap, Pos(0, 0), glyphInfo->rleMetrics);
-        // retrieveBitmap(idx, glyphInfo.get(), *bitmap, Pos(0,0));
-
-        face->glyphs.push_back(glyphInfo);
-        face->bitmaps.push_back(bitmap);
-        face->compressedBitmaps.push_back(compressedBitmap);
-
-        // idx += glyphInfo->packetLength;
-      }
+      face->glyphs.resize(header->glyphCount);
+      memcpy(face->glyphs.data(), &memory_[idx], sizeof(GlyphInfo) * header->glyphCount);
+      idx += sizeof(GlyphInfo) * header->glyphCount;
     }
 
+    face->bitmaps.resize(header->glyphCount, nullptr);
+    face->pixelsPool = (uint8_t *)pixelsPool;
+    face->pixelsPoolIndexes.assign(&(*glyphsPixelPoolIndexes)[0],
+                                   &(*glyphsPixelPoolIndexes)[header->glyphCount]);
+
     if (&memory_[idx] != (uint8_t *)pixelsPool) {
       return false;
     }
@@ -184,43 +321,13 @@ bool IBMFFontMod::load() {
       face->header = header;
       faces_.push_back(std::move(face));
     } else {
-      if (header->ligKernStepCount > 0) {
-        face->ligKernSteps.reserve(header->ligKernStepCount);
-        for (int j = 0; j < header->ligKernStepCount; j++) {
-          LigKernStep step;
-          memcpy(&step, &memory_[idx], sizeof(LigKernStep));
-
-          face->ligKernSteps.push_back(step);
+      // The glyphs' lig/kern programs will be retrieved on first access (see getLigKern())
+      face->ligKernSteps.resize(header->ligKernStepCount);
+      memcpy(face->ligKernSteps.data(), &memory_[idx],
+             sizeof(LigKernStep) * header->ligKernStepCount);
+      idx += sizeof(LigKernStep) * header->ligKernStepCount;
 
-          idx += sizeof(LigKernStep);
-        }
-      }
-
-      for (GlyphCode glyphCode = 0; glyphCode < header->glyphCount; glyphCode++) {
-        GlyphLigKernPtr glk = GlyphLigKernPtr(new GlyphLigKern);
-
-        if (face->glyphs[glyphCode]->ligKernPgmIndex != 255) {
-          int lk_idx = face->glyphs[glyphCode]->ligKernPgmIndex;
-          if (lk_idx < header->ligKernStepCount) {
-            if ((face->ligKernSteps[lk_idx].b.goTo.isAGoTo) &&
-                (face->ligKernSteps[lk_idx].b.kern.isAKern)) {
-              lk_idx = face->ligKernSteps[lk_idx].b.goTo.displacement;
-            }
-            do {
-              if (face->ligKernSteps[lk_idx].b.kern.isAKern) { // true = kern, false = ligature
-                glk->kernSteps.push_back(
-                    GlyphKernStep{.nextGlyphCode = face->ligKernSteps[lk_idx].a.data.nextGlyphCode,
-                                  .kern          = face->ligKernSteps[lk_idx].b.kern.kerningValue});
-              } else {
-                glk->ligSteps.push_back(GlyphLigStep{
-                    .nextGlyphCode        = face->ligKernSteps[lk_idx].a.data.nextGlyphCode,
-                    .replacementGlyphCode = face->ligKernSteps[lk_idx].b.repl.replGlyphCode});
-              }
-            } while (!face->ligKernSteps[lk_idx++].a.data.stop);
-          }
-        }
-        face->glyphsLigKern.push_back(glk);
-      }
+      face->glyphsLigKern.resize(header->glyphCount, nullptr);
 
       face->header = header;
       faces_.push_back(std::move(face));
@@ -236,22 +343,24 @@ bool IBMFFontMod::load() {
     return false;                                                                                  \
   }
 
-#define WRITE2(v, size)                                                                            \
-  if (out.writeRawData((char *)v, size) == -1) {                                                   \
-    lastError_ = 1;                                                                                \
-    poolIndexes->clear();                                                                          \
-    poolData->clear();                                                                             \
-    delete poolData;                                                                               \
-    delete poolIndexes;                                                                            \
-    return false;                                                                                  \
-  }
-
-auto IBMFFontMod::save(QDataStream &out) -> bool {
+/// @brief Save the font
+///
+/// @param out The stream to write the font to.
+/// @param progress If not nullptr, called once before the first face is processed and
+///                 after each face is written. Returning false from it cancels the save.
+/// @param maxCompression true to look for the smallest encoding of every glyph bitmap.
+/// @param log If not nullptr, receives the bytes saved in each face in maxCompression mode.
+/// @return true if the font was saved. Otherwise, getLastError() gives the reason.
+auto IBMFFontMod::save(QDataStream &out, SaveProgress progress, bool maxCompression,
+                       QTextStream *log) -> bool {
 
   lastError_ = 0;
 
   if (preamble_.bits.fontFormat != FontFormat::BACKUP) {
-    if (!prepareLigKernVectors()) return false;
+    if (!prepareLigKernVectors()) {
+      lastError_ = 8;
+      return false;
+    }
   }
 
   WRITE(&preamble_, sizeof(Preamble));
@@ -268,6 +377,12 @@ auto IBMFFontMod::save(QDataStream &out) -> bool {
     WRITE(&filler, 1);
   }
 
+  int faceIdx = 0;
+  if ((progress != nullptr) && !progress(0, preamble_.faceCount)) {
+    lastError_ = 7;
+    return false;
+  }
+
   uint32_t offset    = 0;
   auto     offsetPos = out.device()->pos();
   for (int i = 0; i < preamble_.faceCount; i++) {
@@ -295,81 +410,71 @@ auto IBMFFontMod::save(QDataStream &out) -> bool {
       return false;
     }
 
-    int                    idx         = 0;
-    int                    glyphCount  = 0;
-    std::vector<uint8_t>  *poolData    = new std::vector<uint8_t>();
-    std::vector<uint32_t> *poolIndexes = new std::vector<uint32_t>();
+    int                         glyphCount = 0;
+    Pixels                      poolData;
+    std::vector<PixelPoolIndex> poolIndexes;
+    std::vector<RLEPacket>      packets;
+
+    if (!encodeBitmaps(*face, packets, maxCompression)) {
+      lastError_ = 3;
+      return false;
+    }
+
+    // Packets are concatenated in glyph order. Their metrics are applied to the face only
+    // now, as the encoding retrieved the glyphs not yet decoded from the current pool.
+    int saved = 0;
+    poolIndexes.reserve(packets.size());
+    for (auto &packet : packets) {
+      poolIndexes.push_back((packet.length == 0) ? 0 : poolData.size());
+      poolData.insert(poolData.end(), packet.pixels, packet.pixels + packet.length);
+      saved += packet.saved;
+    }
+
+    if (maxCompression && (log != nullptr)) {
+      int    defaultSize = poolData.size() + saved;
+      double percent     = (defaultSize == 0) ? 0.0 : (100.0 * saved) / defaultSize;
+      *log << "Face " << +face->header->pointSize << "pts: pixels pool of " << poolData.size()
+           << " bytes, " << saved << " bytes (" << QString::number(percent, 'f', 1)
+           << "%) less than the " << defaultSize << " bytes of the default compression."
+           << Qt::endl;
+    }
 
     if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
+      int idx = 0;
       for (auto &glyph : face->backupGlyphs) {
-        if (face->bitmaps[idx]->dim.width == 0) {
-          glyph->rleMetrics.dynF         = 14;
-          glyph->rleMetrics.firstIsBlack = false;
-          glyph->packetLength            = 0;
-          poolIndexes->push_back(0);
-          idx += 1;
-        } else {
-          RLEGenerator *gen = new RLEGenerator;
-          if (!gen->encodeBitmap(face->bitmaps[idx++])) {
-            poolData->clear();
-            delete poolData;
-            poolIndexes->clear();
-            delete poolIndexes;
-
-            lastError_ = 3;
-            return false;
-          }
-          glyph->rleMetrics.dynF         = gen->getDynF();
-          glyph->rleMetrics.firstIsBlack = gen->getFirstIsBlack();
-          auto data                      = gen->getData();
-          glyph->packetLength            = data->size();
-          poolIndexes->push_back(poolData->size());
-          copy(data->begin(), data->end(), std::back_inserter(*poolData));
-          delete gen;
-        }
+        glyph->rleMetrics.dynF         = packets[idx].dynF;
+        glyph->rleMetrics.firstIsBlack = packets[idx].firstIsBlack;
+        glyph->packetLength            = packets[idx].length;
+        idx++;
       }
     } else {
+      int idx = 0;
       for (auto &glyph : face->glyphs) {
-        if (face->bitmaps[idx]->dim.width == 0) {
-          glyph->rleMetrics.dynF         = 14;
-          glyph->rleMetrics.firstIsBlack = false;
-          glyph->packetLength            = 0;
-          poolIndexes->push_back(0);
-          idx += 1;
-        } else {
-          RLEGenerator *gen = new RLEGenerator;
-          if (!gen->encodeBitmap(face->bitmaps[idx++])) {
-            poolData->clear();
-            delete poolData;
-            poolIndexes->clear();
-            delete poolIndexes;
-
-            lastError_ = 3;
-            return false;
-          }
-          glyph->rleMetrics.dynF         = gen->getDynF();
-          glyph->rleMetrics.firstIsBlack = gen->getFirstIsBlack();
-          auto data                      = gen->getData();
-          glyph->packetLength            = data->size();
-          poolIndexes->push_back(poolData->size());
-          copy(data->begin(), data->end(), std::back_inserter(*poolData));
-          delete gen;
-        }
+        glyph.rleMetrics.dynF         = packets[idx].dynF;
+        glyph.rleMetrics.firstIsBlack = packets[idx].firstIsBlack;
+        glyph.packetLength            = packets[idx].length;
+        idx++;
       }
     }
 
-    fill = 4 - (poolData->size() + (sizeof(GlyphInfo) * face->header->glyphCount) &
+    // The saved packets become the source of the (possibly evicted) bitmaps
+    face->savedPixelsPool   = std::make_shared<const Pixels>(std::move(poolData));
+    face->pixelsPool        = face->savedPixelsPool->data();
+    face->pixelsPoolIndexes = std::move(poolIndexes);
+    face->fingerprints.clear(); // The glyphs RLE metrics changed
+
+    fill = 4 - (face->savedPixelsPool->size() + (sizeof(GlyphInfo) * face->header->glyphCount) &
                 3); // to keep alignment to 32bits offsets
     if (fill == 4) fill = 0;
 
-    face->header->pixelsPoolSize = poolData->size() + fill;
+    face->header->pixelsPoolSize = face->savedPixelsPool->size() + fill;
     face->header->ligKernStepCount =
         (preamble_.bits.fontFormat == FontFormat::BACKUP) ? 0 : face->ligKernSteps.size();
 
-    WRITE2(face->header.get(), sizeof(FaceHeader));
+    WRITE(face->header.get(), sizeof(FaceHeader));
 
-    for (auto idx : *poolIndexes) {
-      WRITE2(&idx, sizeof(uint32_t));
+    for (auto idx : face->pixelsPoolIndexes) {
+      WRITE(&idx, sizeof(uint32_t));
     }
 
     if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
@@ -377,36 +482,26 @@ auto IBMFFontMod::save(QDataStream &out) -> bool {
       for (auto &glyph : face->backupGlyphs) {
         glyph->ligCount  = face->backupGlyphsLigKern[idx]->ligSteps.size();
         glyph->kernCount = face->backupGlyphsLigKern[idx]->kernSteps.size();
-        WRITE2(glyph.get(), sizeof(BackupGlyphInfo));
+        WRITE(glyph.get(), sizeof(BackupGlyphInfo));
         glyphCount++;
         idx++;
       }
     } else {
-      for (auto &glyph : face->glyphs) {
-        WRITE2(glyph.get(), sizeof(GlyphInfo));
-        glyphCount++;
-      }
+      WRITE(face->glyphs.data(), sizeof(GlyphInfo) * face->glyphs.size());
+      glyphCount = face->glyphs.size();
     }
 
     if (glyphCount != face->header->glyphCount) {
       lastError_ = 5;
-      poolIndexes->clear();
-      poolData->clear();
-      delete poolData;
-      delete poolIndexes;
       return false;
     }
 
-    WRITE2(poolData->data(), poolData->size());
+    face->savedPixelsPoolPos = out.device()->pos();
+    WRITE(face->savedPixelsPool->data(), face->savedPixelsPool->size());
     while (fill--) {
-      WRITE2(&filler, 1);
+      WRITE(&filler, 1);
     }
 
-    poolIndexes->clear();
-    poolData->clear();
-    delete poolData;
-    delete poolIndexes;
-
     if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
       int idx = 0;
       for (auto &glyph : face->backupGlyphs) {
@@ -431,12 +526,118 @@ auto IBMFFontMod::save(QDataStream &out) -> bool {
         return false;
       }
     }
+
+    if ((progress != nullptr) && !progress(++faceIdx, preamble_.faceCount)) {
+      lastError_ = 7;
+      return false;
+    }
   }
   return true;
 }
 
+/// @brief Retrieve the RLE packets of all glyphs of a face.
+///
+/// Glyphs whose bitmap was not modified since the font was loaded or last saved (see
+/// MODIFIED_BITMAP) reuse their current packet as is. Only the modified ones are
+/// encoded. They are independent of each other: they are split into chunks that are
+/// processed by a pool of worker threads. Each glyph gets its own packet, so the
+/// result doesn't depend on the number of threads or on the processing order.
+///
+/// With maxCompression, the smallest encoding of every glyph is looked for. A current
+/// packet is kept unless a shorter one is found, such that the glyph metrics don't change
+/// (see buildModificationsFrom()) when nothing is gained.
+///
+/// @param face The face to encode.
+/// @param packets The packets of the face, in glyph order.
+/// @param maxCompression true to look for the smallest encoding of all bitmaps.
+/// @return true if all bitmaps were encoded.
+auto IBMFFontMod::encodeBitmaps(Face &face, std::vector<RLEPacket> &packets,
+                                bool maxCompression) -> bool {
+
+  int              glyphCount = face.bitmaps.size();
+  std::vector<int> dirtyGlyphs;
+
+  packets.resize(glyphCount);
+  for (int idx = 0; idx < glyphCount; idx++) {
+    if ((idx < face.pixelsPoolIndexes.size()) &&
+        (face.pixelsPoolIndexes[idx] != MODIFIED_BITMAP)) {
+      auto reuse = [&](auto &glyph) {
+        packets[idx].dynF         = glyph.rleMetrics.dynF;
+        packets[idx].firstIsBlack = glyph.rleMetrics.firstIsBlack;
+        packets[idx].pixels       = &face.pixelsPool[face.pixelsPoolIndexes[idx]];
+        packets[idx].length       = glyph.packetLength;
+      };
+      if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
+        reuse(*face.backupGlyphs[idx]);
+      } else {
+        reuse(face.glyphs[idx]);
+      }
+      if (maxCompression && (packets[idx].length > 0)) dirtyGlyphs.push_back(idx);
+    } else {
+      dirtyGlyphs.push_back(idx);
+    }
+  }
+
+  if (dirtyGlyphs.empty()) return true;
+
+  int chunkCount = (dirtyGlyphs.size() + ENCODING_CHUNK_SIZE - 1) / ENCODING_CHUNK_SIZE;
+
+  std::atomic<int>  nextChunk = 0;
+  std::atomic<bool> failed    = false;
+
+  // Modified bitmaps are always present in the face: the workers only read them. The
+  // other ones are decoded without being kept.
+  auto worker = [&]() {
+    int chunkIdx;
+    while (!failed && ((chunkIdx = nextChunk++) < chunkCount)) {
+      int first = chunkIdx * ENCODING_CHUNK_SIZE;
+      int last  = std::min<int>(first + ENCODING_CHUNK_SIZE, dirtyGlyphs.size());
+      for (int i = first; i < last; i++) {
+        int        idx    = dirtyGlyphs[i];
+        RLEPacket &packet = packets[idx];
+        BitmapPtr  bitmap = getBitmap(face, idx, false);
+        if (bitmap->dim.width == 0) {
+          packet.dynF         = 14;
+          packet.firstIsBlack = false;
+        } else {
+          RLEGenerator gen;
+          if (!gen.encodeBitmap(bitmap, maxCompression)) {
+            failed = true;
+            return;
+          }
+          // A reused packet is only replaced by a shorter one
+          bool reused    = packet.pixels != nullptr;
+          int  length    = gen.getData()->size();
+          int  reference = reused ? packet.length : gen.getDefaultLength();
+          if (reused && (length >= reference)) continue;
+          packet.saved = reference - length;
+          packet.dynF         = gen.getDynF();
+          packet.firstIsBlack = gen.getFirstIsBlack();
+          packet.data         = std::move(*gen.getData());
+          packet.pixels       = packet.data.data();
+          packet.length       = packet.data.size();
+        }
+      }
+    }
+  };
+
+  int threadCount = std::clamp<int>(std::thread::hardware_concurrency(), 1, chunkCount);
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < threadCount; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  return !failed;
+}
+
 auto IBMFFontMod::saveFaceHeader(int faceIndex, FaceHeader &face_header) -> bool {
   if (faceIndex < preamble_.faceCount) {
+    modificationCount_++;
     memcpy(faces_[faceIndex]->header.get(), &face_header, sizeof(FaceHeader));
     return true;
   }
@@ -453,18 +654,16 @@ auto IBMFFontMod::findFace(uint8_t pointSize) -> FacePtr {
 
 auto IBMFFontMod::findGlyphIndex(FacePtr face, char32_t codePoint) -> int {
 
-  int idx = 0;
-  for (auto &glyph : face->backupGlyphs) {
-    if (glyph->codePoint == codePoint) return idx;
-    idx++;
-  }
-  return -1;
+  auto it = face->backupGlyphIndexes.find(codePoint);
+  return (it != face->backupGlyphIndexes.end()) ? it->second : -1;
 }
 
 auto IBMFFontMod::saveGlyph(int faceIndex, int glyphCode, GlyphInfoPtr newGlyphInfo,
                             BitmapPtr newBitmap, GlyphLigKernPtr glyphLigKern, IBMFFontModPtr font)
     -> bool {
 
+  modificationCount_++;
+
   if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
     if ((font == nullptr) || !font->isInitialized() || !isInitialized()) {
       return false;
@@ -500,47 +699,34 @@ auto IBMFFontMod::saveGlyph(int faceIndex, int glyphCode, GlyphInfoPtr newGlyphI
 
     int idx = findGlyphIndex(face, backupGlyphInfo->codePoint);
 
-    if (idx != -1) {
-      face->backupGlyphsLigKern[idx]->ligSteps.clear();
-      face->backupGlyphsLigKern[idx]->kernSteps.clear();
-      for (auto &l : glyphLigKern->ligSteps) {
-        BackupGlyphLigStep ls;
-        ls.nextCodePoint        = font->getUTF32(l.nextGlyphCode);
-        ls.replacementCodePoint = font->getUTF32(l.replacementGlyphCode);
-        face->backupGlyphsLigKern[idx]->ligSteps.push_back(ls);
-      }
-      for (auto &k : glyphLigKern->kernSteps) {
-        BackupGlyphKernStep ks;
-        ks.nextCodePoint = font->getUTF32(k.nextGlyphCode);
-        ks.kern          = k.kern;
-        face->backupGlyphsLigKern[idx]->kernSteps.push_back(ks);
-      }
+    // As for the other formats, the lig/kern programs and bitmaps are replaced, never
+    // modified in place, and the font keeps its own bitmap copy (see snapshotOf()).
+    BackupGlyphLigKernPtr glk = BackupGlyphLigKernPtr(new BackupGlyphLigKern);
+    for (auto &l : glyphLigKern->ligSteps) {
+      BackupGlyphLigStep ls;
+      ls.nextCodePoint        = font->getUTF32(l.nextGlyphCode);
+      ls.replacementCodePoint = font->getUTF32(l.replacementGlyphCode);
+      glk->ligSteps.push_back(ls);
+    }
+    for (auto &k : glyphLigKern->kernSteps) {
+      BackupGlyphKernStep ks;
+      ks.nextCodePoint = font->getUTF32(k.nextGlyphCode);
+      ks.kern          = k.kern;
+      glk->kernSteps.push_back(ks);
+    }
 
-      backupGlyphInfo->ligCount  = face->backupGlyphsLigKern[idx]->ligSteps.size();
-      backupGlyphInfo->kernCount = face->backupGlyphsLigKern[idx]->kernSteps.size();
+    backupGlyphInfo->ligCount  = glk->ligSteps.size();
+    backupGlyphInfo->kernCount = glk->kernSteps.size();
 
-      face->backupGlyphs[idx]    = backupGlyphInfo;
-      face->bitmaps[idx]         = newBitmap;
+    if (idx != -1) {
+      face->backupGlyphsLigKern[idx] = glk;
+      face->backupGlyphs[idx]        = backupGlyphInfo;
+      setBitmap(*face, idx, std::make_shared<Bitmap>(*newBitmap));
     } else {
-      BackupGlyphLigKernPtr glk = BackupGlyphLigKernPtr(new BackupGlyphLigKern);
-      for (auto &l : glyphLigKern->ligSteps) {
-        BackupGlyphLigStep ls;
-        ls.nextCodePoint        = font->getUTF32(l.nextGlyphCode);
-        ls.replacementCodePoint = font->getUTF32(l.replacementGlyphCode);
-        glk->ligSteps.push_back(ls);
-      }
-      for (auto &k : glyphLigKern->kernSteps) {
-        BackupGlyphKernStep ks;
-        ks.nextCodePoint = font->getUTF32(k.nextGlyphCode);
-        ks.kern          = k.kern;
-        glk->kernSteps.push_back(ks);
-      }
-
-      backupGlyphInfo->ligCount  = glk->ligSteps.size();
-      backupGlyphInfo->kernCount = glk->kernSteps.size();
-
+      face->backupGlyphIndexes.emplace(backupGlyphInfo->codePoint, face->backupGlyphs.size());
       face->backupGlyphs.push_back(backupGlyphInfo);
-      face->bitmaps.push_back(newBitmap);
+      face->bitmaps.push_back(std::make_shared<Bitmap>(*newBitmap));
+      if (!face->pixelsPoolIndexes.empty()) face->pixelsPoolIndexes.push_back(MODIFIED_BITMAP);
       face->backupGlyphsLigKern.push_back(glk);
 
       face->header->glyphCount += 1;
@@ -551,9 +737,11 @@ auto IBMFFontMod::saveGlyph(int faceIndex, int glyphCode, GlyphInfoPtr newGlyphI
       return false;
     }
 
-    faces_[faceIndex]->glyphs[glyphCode]        = newGlyphInfo;
-    faces_[faceIndex]->bitmaps[glyphCode]       = newBitmap;
-    faces_[faceIndex]->glyphsLigKern[glyphCode] = glyphLigKern;
+    // The font keeps its own copies, as the bitmaps and lig/kern programs of the font may
+    // be shared with viewGlyph() callers, and the caller may go on modifying its own.
+    faces_[faceIndex]->glyphs[glyphCode]        = *newGlyphInfo;
+    faces_[faceIndex]->glyphsLigKern[glyphCode] = std::make_shared<GlyphLigKern>(*glyphLigKern);
+    setBitmap(*faces_[faceIndex], glyphCode, std::make_shared<Bitmap>(*newBitmap));
   }
 
   return true;
@@ -580,7 +768,8 @@ auto IBMFFontMod::saveGlyph(int faceIndex, int glyphCode, GlyphInfoPtr newGlyphI
 /// @return True if a ligature was found, false otherwise.
 ///
 auto IBMFFontMod::ligKern(int faceIndex, const GlyphCode glyphCode1, GlyphCode *glyphCode2,
-                          FIX16 *kern, bool *kernPairPresent, GlyphLigKernPtr bypassLigKern) const
+                          FIX16 *kern, bool *kernPairPresent,
+                          GlyphLigKernConstPtr bypassLigKern) const
     -> bool {
 
   *kern            = 0;
@@ -593,12 +782,13 @@ auto IBMFFontMod::ligKern(int faceIndex, const GlyphCode glyphCode1, GlyphCode *
   }
 
   //
-  GlyphLigSteps  *ligSteps;
-  GlyphKernSteps *kernSteps;
+  const GlyphLigSteps  *ligSteps;
+  const GlyphKernSteps *kernSteps;
 
   if (bypassLigKern == nullptr) {
-    ligSteps  = &faces_[faceIndex]->glyphsLigKern[glyphCode1]->ligSteps;
-    kernSteps = &faces_[faceIndex]->glyphsLigKern[glyphCode1]->kernSteps;
+    GlyphLigKernPtr glyphLigKern = getLigKern(*faces_[faceIndex], glyphCode1);
+    ligSteps                     = &glyphLigKern->ligSteps;
+    kernSteps                    = &glyphLigKern->kernSteps;
   } else {
     ligSteps  = &bypassLigKern->ligSteps;
     kernSteps = &bypassLigKern->kernSteps;
@@ -608,7 +798,7 @@ auto IBMFFontMod::ligKern(int faceIndex, const GlyphCode glyphCode1, GlyphCode *
     return false;
   }
 
-  GlyphCode code = faces_[faceIndex]->glyphs[*glyphCode2]->mainCode;
+  GlyphCode code = faces_[faceIndex]->glyphs[*glyphCode2].mainCode;
   if (preamble_.bits.fontFormat == FontFormat::LATIN) {
     code &= LATIN_GLYPH_CODE_MASK;
   }
@@ -643,13 +833,240 @@ auto IBMFFontMod::getGlyph(int faceIndex, int glyphCode, GlyphInfoPtr &glyphInfo
 
   int glyphIndex = glyphCode;
 
-  glyphInfo      = std::make_shared<GlyphInfo>(*faces_[faceIndex]->glyphs[glyphIndex]);
-  bitmap         = std::make_shared<Bitmap>(*faces_[faceIndex]->bitmaps[glyphIndex]);
-  glyphLigKern   = std::make_shared<GlyphLigKern>(*faces_[faceIndex]->glyphsLigKern[glyphCode]);
+  glyphInfo      = std::make_shared<GlyphInfo>(faces_[faceIndex]->glyphs[glyphIndex]);
+  bitmap         = std::make_shared<Bitmap>(*getBitmap(*faces_[faceIndex], glyphIndex));
+  glyphLigKern   = std::make_shared<GlyphLigKern>(*getLigKern(*faces_[faceIndex], glyphIndex));
 
   return true;
 }
 
+/// @brief Read-only access to a glyph
+///
+/// Contrary to getGlyph(), the bitmap and lig/kern program are not copied: they are the
+/// ones kept in the font (see getBitmap() and getLigKern()). The font never modifies them
+/// in place, a modified glyph getting new ones (see saveGlyph()). They then stay valid
+/// as long as the caller keeps them, even if the glyph is modified or its bitmap evicted
+/// from the decoded bitmaps cache.
+///
+/// @param faceIndex The index of the face where the glyph is located.
+/// @param glyphCode The glyph code.
+/// @param glyphInfo Out. The glyph metrics.
+/// @param bitmap Out. The glyph bitmap. Must not be modified.
+/// @param glyphLigKern Out. The glyph lig/kern program. Must not be modified.
+/// @return true if the glyph exists.
+auto IBMFFontMod::viewGlyph(int faceIndex, int glyphCode, GlyphInfo &glyphInfo,
+                            BitmapConstPtr &bitmap, GlyphLigKernConstPtr &glyphLigKern) const
+    -> bool {
+
+  if ((faceIndex >= preamble_.faceCount) || (glyphCode < 0) ||
+      (glyphCode >= faces_[faceIndex]->header->glyphCount)) {
+    return false;
+  }
+
+  glyphInfo    = faces_[faceIndex]->glyphs[glyphCode];
+  bitmap       = getBitmap(*faces_[faceIndex], glyphCode);
+  glyphLigKern = getLigKern(*faces_[faceIndex], glyphCode);
+
+  return true;
+}
+
+/// @brief Retrieve a glyph bitmap, decoding it from its RLE packet if required
+///
+/// Bitmaps coming from a font file are only decoded on first access. When **keepIt** is
+/// true, the decoded bitmap is kept in the face for future accesses, up to
+/// DECODED_BITMAPS_CACHE_SIZE bitmaps, the oldest decoded ones being released first.
+/// Bulk processing (save, dump, diff) must use **keepIt** = false to not flush the cache.
+///
+/// @param face The face where the glyph is located.
+/// @param glyphIdx The index of the glyph in the face.
+/// @param keepIt True if the decoded bitmap must be kept in the face.
+/// @return The bitmap. Must not be modified by the caller.
+auto IBMFFontMod::getBitmap(Face &face, int glyphIdx, bool keepIt) const -> BitmapPtr {
+  if (face.bitmaps[glyphIdx] != nullptr) {
+    return face.bitmaps[glyphIdx];
+  }
+
+  BitmapPtr  bitmap = BitmapPtr(new Bitmap);
+  RLEBitmap  compressedBitmap;
+  RLEMetrics rleMetrics;
+
+  auto fromGlyph = [&](auto &glyph) {
+    compressedBitmap = RLEBitmap(&face.pixelsPool[face.pixelsPoolIndexes[glyphIdx]],
+                                 glyph.packetLength, Dim(glyph.bitmapWidth, glyph.bitmapHeight));
+    rleMetrics       = glyph.rleMetrics;
+  };
+
+  if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
+    fromGlyph(*face.backupGlyphs[glyphIdx]);
+  } else {
+    fromGlyph(face.glyphs[glyphIdx]);
+  }
+
+  bitmap->pixels = Pixels(compressedBitmap.dim.height * compressedBitmap.dim.width, 0);
+  bitmap->dim    = compressedBitmap.dim;
+
+  RLEExtractor rle;
+  rle.retrieveBitmap(compressedBitmap, *bitmap, Pos(0, 0), rleMetrics);
+
+  if (keepIt) {
+    face.bitmaps[glyphIdx] = bitmap;
+    decodedBitmaps_.push_back(std::make_pair(&face, glyphIdx));
+    while (decodedBitmaps_.size() > DECODED_BITMAPS_CACHE_SIZE) {
+      auto [oldFace, oldIdx] = decodedBitmaps_.front();
+      decodedBitmaps_.pop_front();
+      // Glyph indexes may have been shifted by addCodePoint(). Releasing the wrong
+      // bitmap is harmless as long as it can still be decoded from its packet.
+      if ((oldIdx < oldFace->pixelsPoolIndexes.size()) &&
+          (oldFace->pixelsPoolIndexes[oldIdx] != MODIFIED_BITMAP)) {
+        oldFace->bitmaps[oldIdx] = nullptr;
+      }
+    }
+  }
+
+  return bitmap;
+}
+
+/// @brief Replace a glyph bitmap. The RLE packet of the glyph is dropped as it is
+/// no longer in sync with the bitmap. It will be regenerated at save time. The glyph
+/// fingerprint is dropped as well.
+auto IBMFFontMod::setBitmap(Face &face, int glyphIdx, BitmapPtr bitmap) -> void {
+  face.bitmaps[glyphIdx] = bitmap;
+  if (glyphIdx < face.pixelsPoolIndexes.size()) {
+    face.pixelsPoolIndexes[glyphIdx] = MODIFIED_BITMAP;
+  }
+  if (glyphIdx < face.fingerprints.size()) {
+    face.fingerprints[glyphIdx] = 0;
+  }
+}
+
+/// @brief Retrieve a glyph lig/kern program, extracting it from the face ligKernSteps
+/// if required
+///
+/// When **keepIt** is true, the extracted program is kept in the face and becomes the
+/// glyph's own copy, to be modified as needed. Bulk processing (save, dump, diff) must use
+/// **keepIt** = false to only get a temporary copy.
+///
+/// @param face The face where the glyph is located. Not a BACKUP format face.
+/// @param glyphIdx The index of the glyph in the face.
+/// @param keepIt True if the extracted program must be kept in the face.
+/// @return The lig/kern program.
+auto IBMFFontMod::getLigKern(Face &face, int glyphIdx, bool keepIt) const -> GlyphLigKernPtr {
+  if (face.glyphsLigKern[glyphIdx] != nullptr) {
+    return face.glyphsLigKern[glyphIdx];
+  }
+
+  GlyphLigKernPtr glk    = GlyphLigKernPtr(new GlyphLigKern);
+  auto           &lSteps = face.ligKernSteps;
+
+  if (face.glyphs[glyphIdx].ligKernPgmIndex != 255) {
+    int lk_idx = face.glyphs[glyphIdx].ligKernPgmIndex;
+    if (lk_idx < lSteps.size()) {
+      if ((lSteps[lk_idx].b.goTo.isAGoTo) && (lSteps[lk_idx].b.kern.isAKern)) {
+        lk_idx = lSteps[lk_idx].b.goTo.displacement;
+      }
+      do {
+        if (lSteps[lk_idx].b.kern.isAKern) { // true = kern, false = ligature
+          glk->kernSteps.push_back(
+              GlyphKernStep{.nextGlyphCode = lSteps[lk_idx].a.data.nextGlyphCode,
+                            .kern          = lSteps[lk_idx].b.kern.kerningValue});
+        } else {
+          glk->ligSteps.push_back(
+              GlyphLigStep{.nextGlyphCode        = lSteps[lk_idx].a.data.nextGlyphCode,
+                           .replacementGlyphCode = lSteps[lk_idx].b.repl.replGlyphCode});
+        }
+      } while (!lSteps[lk_idx++].a.data.stop);
+    }
+  }
+
+  if (keepIt) {
+    face.glyphsLigKern[glyphIdx] = glk;
+  }
+
+  return glk;
+}
+
+// One step of a glyph fingerprint computation
+static inline auto fingerprintHash(uint64_t hash, uint64_t value) -> uint64_t {
+  return (hash ^ value) * 0x100000001B3ULL;
+}
+
+/// @brief Compute the fingerprint of a glyph: a 64 bits hash of its metrics, bitmap and
+/// lig/kern program.
+///
+/// Equal glyphs get the same fingerprint. Different fingerprints mean different glyphs,
+/// but equal fingerprints must be confirmed by a complete comparison. Glyph codes (main
+/// code, ligatures and kernings) are hashed as code points, such that the fingerprints
+/// of glyphs from two UTF32 fonts can be compared.
+///
+/// @return The fingerprint, never 0.
+auto IBMFFontMod::glyphFingerprint(const GlyphInfo &glyphInfo, const Bitmap &bitmap,
+                                   const GlyphLigKern &glyphLigKern) const -> uint64_t {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+
+  // The GlyphInfo fields compared by its == operator
+  hash = fingerprintHash(hash, uint64_t(glyphInfo.bitmapWidth) |
+                                   (uint64_t(glyphInfo.bitmapHeight) << 8) |
+                                   (uint64_t(uint8_t(glyphInfo.horizontalOffset)) << 16) |
+                                   (uint64_t(uint8_t(glyphInfo.verticalOffset)) << 24) |
+                                   (uint64_t(glyphInfo.packetLength) << 32) |
+                                   (uint64_t(uint16_t(glyphInfo.advance)) << 48));
+  hash = fingerprintHash(hash, uint64_t(glyphInfo.rleMetrics.dynF) |
+                                   (uint64_t(glyphInfo.rleMetrics.firstIsBlack) << 4) |
+                                   (uint64_t(glyphInfo.rleMetrics.beforeAddedOptKern) << 5) |
+                                   (uint64_t(glyphInfo.rleMetrics.afterAddedOptKern) << 7) |
+                                   (uint64_t(getUTF32(glyphInfo.mainCode)) << 8));
+
+  // The bitmap pixels, 8 at a time
+  const uint8_t *pixels = bitmap.pixels.data();
+  size_t         size   = bitmap.pixels.size();
+  hash = fingerprintHash(hash, (uint64_t(size) << 16) | (uint64_t(bitmap.dim.width) << 8) |
+                                   bitmap.dim.height);
+  size_t idx = 0;
+  for (; (idx + sizeof(uint64_t)) <= size; idx += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, &pixels[idx], sizeof(uint64_t));
+    hash = fingerprintHash(hash, word);
+  }
+  if (idx < size) {
+    uint64_t word = 0;
+    memcpy(&word, &pixels[idx], size - idx);
+    hash = fingerprintHash(hash, word);
+  }
+
+  // The lig/kern program
+  hash = fingerprintHash(hash, (uint64_t(glyphLigKern.ligSteps.size()) << 32) |
+                                   glyphLigKern.kernSteps.size());
+  for (auto &ligStep : glyphLigKern.ligSteps) {
+    hash = fingerprintHash(hash, (uint64_t(getUTF32(ligStep.nextGlyphCode)) << 32) |
+                                     getUTF32(ligStep.replacementGlyphCode));
+  }
+  for (auto &kernStep : glyphLigKern.kernSteps) {
+    hash = fingerprintHash(hash, (uint64_t(getUTF32(kernStep.nextGlyphCode)) << 32) |
+                                     uint16_t(kernStep.kern));
+  }
+
+  return (hash == 0) ? 1 : hash;
+}
+
+/// @brief Retrieve the fingerprint of a glyph of a face, computing it on first access
+///
+/// The fingerprints of a face are only computed and accessed by one thread at a time.
+///
+/// @param face The face where the glyph is located. Not a BACKUP format face.
+/// @param glyphIdx The index of the glyph in the face.
+/// @return The glyph fingerprint (see glyphFingerprint()).
+auto IBMFFontMod::fingerprint(Face &face, int glyphIdx) const -> uint64_t {
+  if (face.fingerprints.size() != face.glyphs.size()) {
+    face.fingerprints.assign(face.glyphs.size(), 0);
+  }
+  if (face.fingerprints[glyphIdx] == 0) {
+    face.fingerprints[glyphIdx] =
+        glyphFingerprint(face.glyphs[glyphIdx], *getBitmap(face, glyphIdx, false),
+                         *getLigKern(face, glyphIdx, false));
+  }
+  return face.fingerprints[glyphIdx];
+}
+
 auto IBMFFontMod::convertToOneBit(const Bitmap &bitmapHeightBits, BitmapPtr *bitmapOneBit) -> bool {
   *bitmapOneBit        = BitmapPtr(new Bitmap);
   (*bitmapOneBit)->dim = bitmapHeightBits.dim;
@@ -671,19 +1088,51 @@ auto IBMFFontMod::convertToOneBit(const Bitmap &bitmapHeightBits, BitmapPtr *bit
   return pix->size() == (bitmapHeightBits.dim.height * ((bitmapHeightBits.dim.width + 7) >> 3));
 }
 
+// Hash of a lig/kern steps sequence, computed from its last step, such that the hash of
+// every suffix of a program is obtained in a single pass
+static inline auto ligKernHash(uint64_t hash, const LigKernStep &step) -> uint64_t {
+  return (hash * 0x100000001B3ULL) ^ ((uint32_t(step.a.whole.val) << 16) | step.b.whole.val);
+}
+
+static inline auto sameSteps(const LigKernStep &e1, const LigKernStep &e2) -> bool {
+  return (e1.a.whole.val == e2.a.whole.val) && (e1.b.whole.val == e2.b.whole.val);
+}
+
+// Index the suffixes of the program that was added at the end of the list, starting at
+// the first index. All programs end with a stop step: a pgm can only be found in the
+// list as one of these suffixes.
+auto IBMFFontMod::addSuffixes(const std::vector<LigKernStep> &list, int first,
+                              LigKernSuffixes &suffixes) const -> void {
+  uint64_t hash = 0;
+  for (int idx = list.size() - 1; idx >= first; idx--) {
+    hash = ligKernHash(hash, list[idx]);
+    suffixes.emplace(hash, idx);
+  }
+}
+
 // In the process of optimizing the size of the ligKern table, this method
 // search to find if a part of the already prepared list contains the same
 // steps as per the pgm received as a parameter. If so, the index of the
-// similar list of steps is returned, else -1
-auto IBMFFontMod::findList(std::vector<LigKernStep> &pgm, std::vector<LigKernStep> &list) const
-    -> int {
-
-  auto pred = [](const LigKernStep &e1, const LigKernStep &e2) -> bool {
-    return (e1.a.whole.val == e2.a.whole.val) && (e1.b.whole.val == e2.b.whole.val);
-  };
+// similar list of steps is returned, else -1. Only the suffixes with the same
+// hash value are compared.
+auto IBMFFontMod::findList(const std::vector<LigKernStep> &pgm,
+                           const std::vector<LigKernStep> &list,
+                           const LigKernSuffixes          &suffixes) const -> int {
+
+  uint64_t hash = 0;
+  for (auto step = pgm.rbegin(); step != pgm.rend(); step++) {
+    hash = ligKernHash(hash, *step);
+  }
 
-  auto it = std::search(list.begin(), list.end(), pgm.begin(), pgm.end(), pred);
-  return (it == list.end()) ? -1 : std::distance(list.begin(), it);
+  auto [first, last] = suffixes.equal_range(hash);
+  for (auto it = first; it != last; it++) {
+    int idx = it->second;
+    if (((idx + pgm.size()) <= list.size()) &&
+        std::equal(pgm.begin(), pgm.end(), list.begin() + idx, sameSteps)) {
+      return idx;
+    }
+  }
+  return -1;
 }
 
 // For all faces:
@@ -692,23 +1141,29 @@ auto IBMFFontMod::findList(std::vector<LigKernStep> &pgm, std::vector<LigKernSte
 // index in the integrated vector, optimizing the glyphs' list to reuse the
 // ones that are similar
 //
-// - If there is some series with index beyond 254, create goto entries. All
-// starting indexes must be before 255
+// - Lays out the pgms such that all starting indexes are before 255, the
+// pgms that cannot be placed there being reached through goto entries
+//
+// Returns false if the lig/kern table of a face cannot be expressed in the
+// IBMF format: more than 255 different pgms, or a list that is too long.
+// As it is called while saving, possibly from a worker thread, nothing is
+// reported to the user here.
 auto IBMFFontMod::prepareLigKernVectors() -> bool {
   for (auto &face : faces_) {
 
-    auto &lkSteps = face->ligKernSteps;
-
-    lkSteps.clear();
+    // The glyphs' programs not yet extracted are retrieved from the current face
+    // ligKernSteps, so the face is updated only once the new list is completed.
+    std::vector<LigKernStep> lkSteps;
 
-    std::set<int> overflowList;     // List of starting pgm index that are larger than 254
-    std::set<int> uniquePgmIndexes; // List of all unique start indexes
+    std::map<int, int> uniquePgmIndexes; // All unique start indexes, with their glyphs count
 
     // Working list for glyphs pgm vector reconstruction
     // = -1 if a glyph's Lig/Kern pgm is empty
-    // < -1 if it has been relocated
-    std::vector<int>         glyphsPgmIndexes(face->header->glyphCount, -1);
-    std::vector<LigKernStep> glyphPgm;
+    std::vector<int> glyphsPgmIndexes(face->header->glyphCount, -1);
+
+    std::vector<std::vector<LigKernStep>> glyphsPgm(face->header->glyphCount);
+    std::vector<int>                      glyphsOrder;
+    LigKernSuffixes                       suffixes;
 
     // ----- Retrieves all ligature and kerning in a single list -----
     //
@@ -717,15 +1172,17 @@ auto IBMFFontMod::prepareLigKernVectors() -> bool {
     // face's ligKernSteps receives the integrated list.
     //
     // Optimization is done to reuse part of pgms that are the same for
-    // a glyph vs the other ones
+    // a glyph vs the other ones. The longest pgms are laid out first, such
+    // that a pgm being the end of a longer one is never duplicated.
 
     int glyphIdx = 0;
     for (int glyphIdx = 0; glyphIdx < face->header->glyphCount; glyphIdx++) {
 
-      auto &lSteps = face->glyphsLigKern[glyphIdx]->ligSteps;
-      auto &kSteps = face->glyphsLigKern[glyphIdx]->kernSteps;
+      auto  glyphLigKern = getLigKern(*face, glyphIdx, false);
+      auto &lSteps       = glyphLigKern->ligSteps;
+      auto &kSteps       = glyphLigKern->kernSteps;
+      auto &glyphPgm     = glyphsPgm[glyphIdx];
 
-      glyphPgm.clear();
       glyphPgm.reserve(lSteps.size() + kSteps.size());
 
       for (auto &lStep : lSteps) {
@@ -740,126 +1197,231 @@ auto IBMFFontMod::prepareLigKernVectors() -> bool {
             .b = {.kern = {.kerningValue = (FIX14)kStep.kern, .isAGoTo = false, .isAKern = true}}});
       }
 
-      if (glyphPgm.size() == 0) {
-        glyphsPgmIndexes[glyphIdx] = -1; // empty list
-      } else {
+      if (glyphPgm.size() > 0) { // empty lists stay at -1 in glyphsPgmIndexes
         glyphPgm[glyphPgm.size() - 1].a.data.stop = true;
-        int sameIdx; // Idx of the equivalent pgm if found (-1 otherwise)
-        //           Must start at 2 as cannot have a sameIdx equal to 0 or 1:
-        //           Cannot negate 0, and -1 is reserved for a null pgm in
-        //           glyphsPgmIndexes
-        if ((sameIdx = findList(glyphPgm, lkSteps)) > 1) {
-          // We found a duplicated list. Remove the duplicate one and make it
-          // point to the first found to be similar.
-          glyphPgm.clear();
-          glyphsPgmIndexes[glyphIdx] = -sameIdx; // negative to signify a duplicate list
-          uniquePgmIndexes.insert(sameIdx);
-        } else {
-          int index = lkSteps.size();
-          uniquePgmIndexes.insert(index);
-          glyphsPgmIndexes[glyphIdx] = index;
-          std::move(glyphPgm.begin(), glyphPgm.end(), std::back_inserter(lkSteps));
-        }
+        glyphsOrder.push_back(glyphIdx);
       }
     }
 
-    // ----- Relocate entries that overflowed beyond 254 -----
+    std::stable_sort(glyphsOrder.begin(), glyphsOrder.end(), [&glyphsPgm](int g1, int g2) {
+      return glyphsPgm[g1].size() > glyphsPgm[g2].size();
+    });
 
-    // Put them in a vector such that we can access them through indices.
+    for (auto glyphIdx : glyphsOrder) {
+      auto &glyphPgm = glyphsPgm[glyphIdx];
+      int   sameIdx; // Idx of the equivalent pgm if found (-1 otherwise)
+      if ((sameIdx = findList(glyphPgm, lkSteps, suffixes)) >= 0) {
+        // We found a duplicated list. Make it point to the first found to be similar.
+        glyphsPgmIndexes[glyphIdx] = sameIdx;
+        uniquePgmIndexes[sameIdx] += 1;
+      } else {
+        int index = lkSteps.size();
+        uniquePgmIndexes[index] += 1;
+        glyphsPgmIndexes[glyphIdx] = index;
+        lkSteps.insert(lkSteps.end(), glyphPgm.begin(), glyphPgm.end());
+        addSuffixes(lkSteps, index, suffixes);
+      }
+    }
 
-    // Compute how many entries we need to add to the lig/kern vector to
-    // redirect over the limiting 255 indexes, and where to add them.
+    // ----- Layout of the pgms -----
+    //
+    // Every start index must be below 255. A start index beyond that is reached
+    // through a goto entry located below 255. The list is split in blocks: a pgm
+    // laid out above, with the pgms that are its suffixes. Some blocks are placed
+    // first, followed by the goto entries of the starts located in the other
+    // blocks. The blocks placed first are the ones avoiding the most goto usages
+    // per step, as long as all their starts and the goto entries are below 255.
+
+    if (uniquePgmIndexes.size() > 255) return false;
+
+    struct Block {
+      int  first;      // index in lkSteps
+      int  length;     // number of steps
+      int  startCount; // number of pgms starting in the block
+      int  refCount;   // number of glyphs using these pgms
+      int  newFirst;   // index in the final list
+      bool placedFirst;
+    };
+
+    std::vector<Block> blocks;
+    for (int idx = 0; idx < lkSteps.size();) {
+      Block block{.first = idx, .startCount = 0, .refCount = 0, .placedFirst = false};
+      while (!lkSteps[idx++].a.data.stop)
+        ;
+      block.length = idx - block.first;
+      for (auto it = uniquePgmIndexes.lower_bound(block.first);
+           (it != uniquePgmIndexes.end()) && (it->first < idx); it++) {
+        block.startCount += 1;
+        block.refCount   += it->second;
+      }
+      blocks.push_back(block);
+    }
 
-    int spaceRequired = 0;
-    int newLigKernIdx = 0;
-    for (auto idx = uniquePgmIndexes.rbegin(); idx != uniquePgmIndexes.rend(); idx++) {
-      if ((*idx + spaceRequired) >= 255) {
-        overflowList.insert(*idx);
-        spaceRequired += 1;
-      } else {
-        if (spaceRequired > 0) {
-          overflowList.insert(*idx);
-          spaceRequired += 1;
-          newLigKernIdx = *idx;
-        }
-        break;
+    // Placing a block first uses (length - startCount) more entries below 255
+    std::vector<int> candidates(blocks.size());
+    std::iota(candidates.begin(), candidates.end(), 0);
+    std::stable_sort(candidates.begin(), candidates.end(), [&blocks](int b1, int b2) {
+      int64_t cost1 = blocks[b1].length - blocks[b1].startCount;
+      int64_t cost2 = blocks[b2].length - blocks[b2].startCount;
+      return (blocks[b1].refCount * cost2) > (blocks[b2].refCount * cost1);
+    });
+
+    int firstSize = 0;
+    int gotoCount = uniquePgmIndexes.size();
+    for (auto blockIdx : candidates) {
+      Block &block = blocks[blockIdx];
+      if ((firstSize + block.length + gotoCount - block.startCount) <= 255) {
+        block.newFirst     = firstSize;
+        block.placedFirst  = true;
+        firstSize         += block.length;
+        gotoCount         -= block.startCount;
       }
     }
 
-    for (auto idx = overflowList.rbegin(); idx != overflowList.rend(); idx++) {
-      // std::cout << *idx << " treatment: " << Qt::endl;
-      LigKernStep ligKernStep;
-      memset(&ligKernStep, 0, sizeof(LigKernStep));
-      ligKernStep.b.goTo.isAKern      = true;
-      ligKernStep.b.goTo.isAGoTo      = true;
-      ligKernStep.b.goTo.displacement = (*idx + spaceRequired);
-
-      // std::cout << "Added goto at location " << *idx << " to point at location "
-      //           << (*idx + spaceRequired) << Qt::endl;
-
-      lkSteps.insert(lkSteps.begin() + newLigKernIdx, ligKernStep);
-      int gCode = 0;
-      for (auto pgmIdx = glyphsPgmIndexes.begin(); pgmIdx != glyphsPgmIndexes.end(); pgmIdx++) {
-        if (abs(*pgmIdx) == *idx) { // Must look at both duplicated and
-                                    // non-duplicated indexes
-          // std::cout << "Entry " << gCode << " pointing at " << *pgmIdx << " redirected to "
-          //           << (-5000 - newLigKernIdx) << Qt::endl;
-          *pgmIdx = -5000 - newLigKernIdx;
+    int newIdx = firstSize + gotoCount;
+    for (auto &block : blocks) {
+      if (!block.placedFirst) {
+        block.newFirst  = newIdx;
+        newIdx         += block.length;
+      }
+    }
+
+    if (newIdx > 0xFFFF) return false;
+
+    // Final list, with the new location of each start index
+    std::vector<LigKernStep> newSteps(newIdx);
+    std::map<int, int>       newPgmIndexes;
+    int                      gotoIdx = firstSize;
+    auto                     start   = uniquePgmIndexes.begin();
+
+    for (auto &block : blocks) {
+      std::copy_n(lkSteps.begin() + block.first, block.length, newSteps.begin() + block.newFirst);
+      for (; (start != uniquePgmIndexes.end()) && (start->first < block.first + block.length);
+           start++) {
+        int newStart = block.newFirst + start->first - block.first;
+        if (block.placedFirst) {
+          newPgmIndexes[start->first] = newStart;
+        } else {
+          if (newStart >= (1 << 14)) return false; // beyond the reach of a goto entry
+          LigKernStep &ligKernStep = newSteps[gotoIdx];
+          memset(&ligKernStep, 0, sizeof(LigKernStep));
+          ligKernStep.b.goTo.isAKern      = true;
+          ligKernStep.b.goTo.isAGoTo      = true;
+          ligKernStep.b.goTo.displacement = newStart;
+          newPgmIndexes[start->first]     = gotoIdx++;
         }
-        gCode++;
       }
-      newLigKernIdx++;
-    } // for
+    }
+
+    std::vector<uint8_t> ligKernPgmIndexes(face->header->glyphCount);
 
     glyphIdx = 0;
-    for (auto &glyph : face->glyphs) {
+    for (auto &ligKernPgmIndex : ligKernPgmIndexes) {
       if (glyphsPgmIndexes[glyphIdx] == -1) {
-        glyph->ligKernPgmIndex = 255;
+        ligKernPgmIndex = 255;
       } else {
-        if ((abs(glyphsPgmIndexes[glyphIdx]) >= 255) && (abs(glyphsPgmIndexes[glyphIdx]) < 5000)) {
-          QMessageBox::warning(nullptr, "Logic Error",
-                               "A logic error was encoutered in method "
-                               "prepareLigKernVectors() "
-                               "-> computed LigKern PGM index >= 255!!");
-          return false;
-        }
-        if (abs(glyphsPgmIndexes[glyphIdx]) >= 5000) {
-          glyph->ligKernPgmIndex = abs(glyphsPgmIndexes[glyphIdx]) - 5000;
-        } else {
-          glyph->ligKernPgmIndex = abs(glyphsPgmIndexes[glyphIdx]);
-        }
+        ligKernPgmIndex = newPgmIndexes[glyphsPgmIndexes[glyphIdx]];
       }
       glyphIdx += 1;
     }
+
+    glyphIdx = 0;
+    for (auto &glyph : face->glyphs) {
+      glyph.ligKernPgmIndex = ligKernPgmIndexes[glyphIdx++];
+    }
+    face->ligKernSteps = std::move(newSteps);
   } // for each face
 
   return true;
 }
 
+// Builds the code point lookup index from the planes and code point bundles. The
+// glyph codes of a plane's bundles are contiguous, starting at the plane's first
+// glyph code.
+auto IBMFFontMod::buildCodePointIndex() -> void {
+  bundlesFirstGlyphCode_.assign(codePointBundles_.size(), 0);
+  bmpGlyphCodes_.clear();
+  glyphCodePoints_.clear();
+
+  if (planes_.size() < 4) return;
+
+  for (int planeIdx = 0; planeIdx < 4; planeIdx++) {
+    auto &plane = planes_[planeIdx];
+    int   gCode = plane.firstGlyphCode;
+    for (int bundleIdx = plane.codePointBundlesIdx;
+         bundleIdx < plane.codePointBundlesIdx + plane.entriesCount; bundleIdx++) {
+      auto &bundle                      = codePointBundles_[bundleIdx];
+      bundlesFirstGlyphCode_[bundleIdx] = gCode;
+      for (int u16 = bundle.firstCodePoint; u16 <= bundle.lastCodePoint; u16++, gCode++) {
+        if (gCode >= glyphCodePoints_.size()) glyphCodePoints_.resize(gCode + 1, 0);
+        glyphCodePoints_[gCode] = u16 | (planeIdx << 16);
+      }
+    }
+  }
+
+  if (planes_[0].entriesCount > 0) {
+    bmpGlyphCodes_.assign(0x10000, NO_GLYPH_CODE);
+    for (int bundleIdx = planes_[0].codePointBundlesIdx;
+         bundleIdx < planes_[0].codePointBundlesIdx + planes_[0].entriesCount; bundleIdx++) {
+      auto &bundle = codePointBundles_[bundleIdx];
+      int   gCode  = bundlesFirstGlyphCode_[bundleIdx];
+      for (int u16 = bundle.firstCodePoint; u16 <= bundle.lastCodePoint; u16++) {
+        bmpGlyphCodes_[u16] = gCode++;
+      }
+    }
+  }
+}
+
+// Verifies the code point lookup index against the planes and bundles, walking them
+// in the same way as the device driver does. Returns false if they don't agree, with
+// the first glyph code in error.
+auto IBMFFontMod::checkCodePointIndex(GlyphCode &glyphCode) const -> bool {
+  for (int planeIdx = 0; planeIdx < planes_.size(); planeIdx++) {
+    auto &plane = planes_[planeIdx];
+    glyphCode   = plane.firstGlyphCode;
+    for (int bundleIdx = plane.codePointBundlesIdx;
+         bundleIdx < plane.codePointBundlesIdx + plane.entriesCount; bundleIdx++) {
+      auto &bundle = codePointBundles_[bundleIdx];
+      for (int u16 = bundle.firstCodePoint; u16 <= bundle.lastCodePoint; u16++, glyphCode++) {
+        char32_t codePoint = u16 | (planeIdx << 16);
+        if ((getUTF32(glyphCode) != codePoint) || (toGlyphCode(codePoint) != glyphCode)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Returns the index of the bundle of a plane containing the code point, or -1 if
+// not present. The bundles of a plane are in code point order.
+auto IBMFFontMod::findBundle(int planeIdx, char16_t u16) const -> int {
+  auto first = codePointBundles_.begin() + planes_[planeIdx].codePointBundlesIdx;
+  auto last  = first + planes_[planeIdx].entriesCount;
+  auto it    = std::lower_bound(first, last, u16, [](const CodePointBundle &bundle, char16_t u16) {
+    return bundle.lastCodePoint < u16;
+  });
+  if ((it == last) || (u16 < it->firstCodePoint)) return -1;
+  return std::distance(codePointBundles_.begin(), it);
+}
+
 auto IBMFFontMod::toGlyphCode(char32_t codePoint) const -> GlyphCode {
 
   GlyphCode glyphCode = NO_GLYPH_CODE;
 
   uint16_t planeIdx   = static_cast<uint16_t>(codePoint >> 16);
 
-  if (planeIdx <= 3) {
-    char16_t u16                = static_cast<char16_t>(codePoint);
+  if ((planeIdx <= 3) && (planes_.size() == 4)) {
+    char16_t u16 = static_cast<char16_t>(codePoint);
 
-    uint16_t codePointBundleIdx = planes_[planeIdx].codePointBundlesIdx;
-    uint16_t entriesCount       = planes_[planeIdx].entriesCount;
-    int      gCode              = planes_[planeIdx].firstGlyphCode;
-    int      i                  = 0;
-    while (i < entriesCount) {
-      if (u16 <= codePointBundles_[codePointBundleIdx].lastCodePoint) {
-        break;
+    if ((planeIdx == 0) && !bmpGlyphCodes_.empty()) {
+      glyphCode = bmpGlyphCodes_[u16];
+    } else {
+      int bundleIdx = findBundle(planeIdx, u16);
+      if (bundleIdx >= 0) {
+        glyphCode =
+            bundlesFirstGlyphCode_[bundleIdx] + u16 - codePointBundles_[bundleIdx].firstCodePoint;
       }
-      gCode += (codePointBundles_[codePointBundleIdx].lastCodePoint -
-                codePointBundles_[codePointBundleIdx].firstCodePoint + 1);
-      i++;
-      codePointBundleIdx++;
-    }
-    if ((i < entriesCount) && (u16 >= codePointBundles_[codePointBundleIdx].firstCodePoint)) {
-      glyphCode = gCode + u16 - codePointBundles_[codePointBundleIdx].firstCodePoint;
     }
   }
 
@@ -976,28 +1538,8 @@ auto IBMFFontMod::translate(char32_t codePoint) const -> GlyphCode {
       }
     }
   } else if (preamble_.bits.fontFormat == FontFormat::UTF32) {
-    uint16_t planeIdx = static_cast<uint16_t>(codePoint >> 16);
-
-    if (planeIdx <= 3) {
-      char16_t u16                = static_cast<char16_t>(codePoint);
-
-      uint16_t codePointBundleIdx = planes_[planeIdx].codePointBundlesIdx;
-      uint16_t entriesCount       = planes_[planeIdx].entriesCount;
-      int      gCode              = planes_[planeIdx].firstGlyphCode;
-      int      i                  = 0;
-      while (i < entriesCount) {
-        if (u16 <= codePointBundles_[codePointBundleIdx].lastCodePoint) {
-          break;
-        }
-        gCode += (codePointBundles_[codePointBundleIdx].lastCodePoint -
-                  codePointBundles_[codePointBundleIdx].firstCodePoint + 1);
-        i++;
-        codePointBundleIdx++;
-      }
-      if ((i < entriesCount) && (u16 >= codePointBundles_[codePointBundleIdx].firstCodePoint)) {
-        glyphCode = gCode + u16 - codePointBundles_[codePointBundleIdx].firstCodePoint;
-      }
-    }
+    GlyphCode gCode = toGlyphCode(codePoint);
+    if (gCode != NO_GLYPH_CODE) glyphCode = gCode;
   }
 
   return glyphCode;
@@ -1007,32 +1549,7 @@ auto IBMFFontMod::translate(char32_t codePoint) const -> GlyphCode {
 auto IBMFFontMod::getUTF32(GlyphCode glyphCode) const -> char32_t {
   char32_t codePoint = 0;
   if (preamble_.bits.fontFormat == FontFormat::UTF32) {
-    int i = 0;
-    while (i < 3) {
-      if (planes_[i + 1].firstGlyphCode > glyphCode) break;
-      i += 1;
-    }
-    if (i < 4) {
-      int planeMask    = i << 16;
-      int bundleIdx    = planes_[i].codePointBundlesIdx;
-      int idx          = planes_[i].firstGlyphCode;
-      int entriesCount = planes_[i].entriesCount;
-      int j            = 0;
-      int bundleSize   = codePointBundles_[bundleIdx].lastCodePoint -
-                       codePointBundles_[bundleIdx].firstCodePoint + 1;
-
-      while (j < entriesCount) {
-        if ((idx + bundleSize) > glyphCode) break;
-        idx += bundleSize;
-        bundleIdx += 1;
-        bundleSize = codePointBundles_[bundleIdx].lastCodePoint -
-                     codePointBundles_[bundleIdx].firstCodePoint + 1;
-        j += 1;
-      }
-      if (j < entriesCount) {
-        codePoint = (codePointBundles_[bundleIdx].firstCodePoint + (glyphCode - idx)) | planeMask;
-      }
-    }
+    if (glyphCode < glyphCodePoints_.size()) codePoint = glyphCodePoints_[glyphCode];
   } else {
     if (glyphCode < fontFormat0CodePoints.size()) {
       codePoint = fontFormat0CodePoints[glyphCode];
@@ -1095,18 +1612,18 @@ auto IBMFFontMod::showBackupGlyphInfo(QTextStream &stream, GlyphCode i,
   stream << Qt::endl;
 }
 
-auto IBMFFontMod::showGlyphInfo(QTextStream &stream, GlyphCode i, const GlyphInfoPtr g) const
+auto IBMFFontMod::showGlyphInfo(QTextStream &stream, GlyphCode i, const GlyphInfo &g) const
     -> void {
   stream << "  [" << i << "]: "
          << "codePoint: " << QString("U+%1").arg(getUTF32(i), 5, 16, QChar('0'))
-         << ", w: " << +g->bitmapWidth << ", h: " << +g->bitmapHeight
-         << ", hoff: " << +g->horizontalOffset << ", voff: " << +g->verticalOffset
-         << ", pktLen: " << +g->packetLength << ", adv: " << +((float)g->advance / 64.0)
-         << ", dynF: " << +g->rleMetrics.dynF << ", 1stBlack: " << +g->rleMetrics.firstIsBlack
-         << ", lKPgmIdx: " << +g->ligKernPgmIndex;
-
-  if (g->mainCode != i) {
-    stream << ", mainCode: " << g->mainCode;
+         << ", w: " << +g.bitmapWidth << ", h: " << +g.bitmapHeight
+         << ", hoff: " << +g.horizontalOffset << ", voff: " << +g.verticalOffset
+         << ", pktLen: " << +g.packetLength << ", adv: " << +((float)g.advance / 64.0)
+         << ", dynF: " << +g.rleMetrics.dynF << ", 1stBlack: " << +g.rleMetrics.firstIsBlack
+         << ", lKPgmIdx: " << +g.ligKernPgmIndex;
+
+  if (g.mainCode != i) {
+    stream << ", mainCode: " << g.mainCode;
   }
   stream << Qt::endl;
 }
@@ -1177,11 +1694,11 @@ auto IBMFFontMod::showFace(QTextStream &stream, FacePtr face, bool withBitmaps)
       showBackupLigKerns(stream, face->backupGlyphsLigKern[i]);
     } else {
       showGlyphInfo(stream, i, face->glyphs[i]);
-      showLigKerns(stream, face->glyphsLigKern[i]);
+      showLigKerns(stream, getLigKern(*face, i, false));
     }
 
     if (withBitmaps) {
-      showBitmap(stream, face->bitmaps[i]);
+      showBitmap(stream, getBitmap(*face, i, false));
     }
   }
 }
@@ -1233,23 +1750,33 @@ auto IBMFFontMod::showFont(QTextStream &stream, QString fontName, bool withBitma
 }
 
 void IBMFFontMod::recomputeLigatures() {
+  modificationCount_++;
   for (auto &face : faces_) {
     // Recompute all ligatures from the pre-defined table
 
     for (uint16_t glyphCode = 0; glyphCode < face->header->glyphCount; glyphCode++) {
-      char32_t firstChar = getUTF32(glyphCode);
-      face->glyphsLigKern[glyphCode]->ligSteps.clear();
+      char32_t      firstChar = getUTF32(glyphCode);
+      GlyphLigSteps ligSteps;
       for (auto &ligature : ligatures) {
         if (ligature.firstChar == firstChar) {
           GlyphCode nextGlyphCode        = translate(ligature.nextChar);
           GlyphCode replacementGlyphCode = translate(ligature.replacement);
           if ((nextGlyphCode != NO_GLYPH_CODE) && (nextGlyphCode != SPACE_CODE) &&
               (replacementGlyphCode != NO_GLYPH_CODE) && (replacementGlyphCode != SPACE_CODE)) {
-            face->glyphsLigKern[glyphCode]->ligSteps.push_back(GlyphLigStep{
-               .nextGlyphCode = nextGlyphCode, .replacementGlyphCode = replacementGlyphCode});
+            ligSteps.push_back(GlyphLigStep{.nextGlyphCode        = nextGlyphCode,
+                                            .replacementGlyphCode = replacementGlyphCode});
           }
         }
       }
+      // Programs still in the face ligKernSteps are only extracted when changed
+      // The program is replaced, not modified in place (see viewGlyph())
+      auto glyphLigKern = getLigKern(*face, glyphCode, false);
+      if (glyphLigKern->ligSteps != ligSteps) {
+        glyphLigKern                   = std::make_shared<GlyphLigKern>(*glyphLigKern);
+        glyphLigKern->ligSteps         = ligSteps;
+        face->glyphsLigKern[glyphCode] = glyphLigKern;
+        if (glyphCode < face->fingerprints.size()) face->fingerprints[glyphCode] = 0;
+      }
     }
   }
 }
@@ -1258,6 +1785,8 @@ auto IBMFFontMod::importModificationsFrom(QTextStream &stream, QString fontName,
                                           IBMFFontModPtr fromBackup, IBMFFontModPtr toBackup,
                                           IBMFFontModPtr thisFont) -> void {
 
+  modificationCount_++;
+
   stream << "Font " << fontName << Qt::endl
          << "Importing Font Modifications from File " << fileName << ":" << Qt::endl;
 
@@ -1265,6 +1794,24 @@ auto IBMFFontMod::importModificationsFrom(QTextStream &stream, QString fontName,
 
   accepted = rejected = acceptedWithModif = 0;
 
+  // User defined code points absent from the current font are added all at
+  // once, such that glyph codes are shifted (and the kerning and ligature
+  // references adjusted) only one time.
+
+  std::set<char32_t> userCodePoints;
+  for (auto &backupFace : fromBackup->faces_) {
+    for (int bidx = 0; bidx < backupFace->header->glyphCount; bidx++) {
+      auto codePoint = backupFace->backupGlyphs[bidx]->codePoint;
+      if ((codePoint >= 0xE000) && (codePoint <= 0xF8FF) &&
+          (toGlyphCode(codePoint) == NO_GLYPH_CODE)) {
+        userCodePoints.insert(codePoint);
+      }
+    }
+  }
+  if (!userCodePoints.empty()) {
+    addCodePoints(toBackup, thisFont, userCodePoints);
+  }
+
   // For each face part of the backup data
   for (auto &backupFace : fromBackup->faces_) {
 
@@ -1278,33 +1825,12 @@ auto IBMFFontMod::importModificationsFrom(QTextStream &stream, QString fontName,
     if (faceIdx < preamble_.faceCount) {
       auto &face = faces_[faceIdx];
 
-      // Adding new user defined code points will have an impact on the
-      // glyph indexes passed the user space (>= first added user defined code point).
-      // Kerning and ligatures pointing at indexes above or equal to the first added
-      // codepoint will need adjustments done after the for loop
-
-      int      addedUserCodePointsCount         = 0;
-      uint16_t firstUserCodePointAddedGlyphCode = 0;
-
       // For each code point that is part of the backup
       for (int bidx = 0; bidx < backupFace->header->glyphCount; bidx++) {
 
         auto    &bGlyph    = backupFace->backupGlyphs[bidx];
         uint16_t glyphCode = translate(bGlyph->codePoint);
 
-        // If the code point is absent from the current font, but is
-        // a user defined code point, add it to the font, and
-        // retrieve it's glyphCode (it's index in the font)
-        if (((glyphCode == NO_GLYPH_CODE) || (glyphCode == SPACE_CODE)) &&
-            ((bGlyph->codePoint >= 0xE000) && (bGlyph->codePoint <= 0xF8FF))) {
-          addCodePoint(toBackup, thisFont, bGlyph->codePoint);
-          glyphCode = translate(bGlyph->codePoint);
-          if (firstUserCodePointAddedGlyphCode == 0) {
-            firstUserCodePointAddedGlyphCode = glyphCode;
-          }
-          addedUserCodePointsCount += 1;
-        }
-
         uint16_t mainGlyphCode = translate(bGlyph->mainCodePoint);
 
         if ((glyphCode != NO_GLYPH_CODE) && (glyphCode != SPACE_CODE)) {
@@ -1333,8 +1859,8 @@ auto IBMFFontMod::importModificationsFrom(QTextStream &stream, QString fontName,
 
           // Generate Bitmap
 
-          auto newBitmap = BitmapPtr(
-              new Bitmap(backupFace->bitmaps[bidx]->pixels, backupFace->bitmaps[bidx]->dim));
+          auto backupBitmap = fromBackup->getBitmap(*backupFace, bidx, false);
+          auto newBitmap    = BitmapPtr(new Bitmap(backupBitmap->pixels, backupBitmap->dim));
 
           // Ligatures and Kernings
 
@@ -1374,9 +1900,9 @@ auto IBMFFontMod::importModificationsFrom(QTextStream &stream, QString fontName,
             }
           }
 
-          *face->glyphs[glyphCode]        = *newInfo;
-          *face->bitmaps[glyphCode]       = *newBitmap;
-          *face->glyphsLigKern[glyphCode] = *newLigKern;
+          face->glyphs[glyphCode]        = *newInfo;
+          face->glyphsLigKern[glyphCode] = GlyphLigKernPtr(new GlyphLigKern(*newLigKern));
+          setBitmap(*face, glyphCode, BitmapPtr(new Bitmap(*newBitmap)));
 
           toBackup->saveGlyph(faceIdx, glyphCode, newInfo, newBitmap, newLigKern, thisFont);
 
@@ -1410,8 +1936,11 @@ auto IBMFFontMod::glyphIsModified(int faceIdx, GlyphCode glyphCode, BitmapPtr &b
                                   GlyphInfoPtr &glyphInfo, GlyphLigKernPtr &ligKern) const -> bool {
   FacePtr face = faces_[faceIdx];
 
-  return !((*face->glyphs[glyphCode] == *glyphInfo) && (*face->bitmaps[glyphCode] == *bitmap) &&
-           (*face->glyphsLigKern[glyphCode] == *ligKern));
+  // Called on each edit of the glyph: hashing the edited glyph would cost more than this
+  // comparison, which stops at the first difference, the pixels being compared by memcmp.
+  return !((face->glyphs[glyphCode] == *glyphInfo) &&
+           (*getBitmap(*face, glyphCode) == *bitmap) &&
+           (*getLigKern(*face, glyphCode) == *ligKern));
 }
 
 auto IBMFFontMod::buildModificationsFrom(QTextStream &stream, IBMFFontModPtr fromFont,
@@ -1433,39 +1962,145 @@ auto IBMFFontMod::buildModificationsFrom(QTextStream &stream, IBMFFontModPtr fro
     auto newBitmap       = BitmapPtr(new Bitmap);
     auto newGlyphLigKern = GlyphLigKernPtr(new GlyphLigKern);
 
-    *newGlyphInfo        = *face->glyphs[glyphCode];
-    *newBitmap           = *face->bitmaps[glyphCode];
-    *newGlyphLigKern     = *face->glyphsLigKern[glyphCode];
+    *newGlyphInfo        = face->glyphs[glyphCode];
+    *newBitmap           = *thisFont->getBitmap(*face, glyphCode, false);
+    *newGlyphLigKern     = *thisFont->getLigKern(*face, glyphCode, false);
 
     backup->saveGlyph(faceIdx, glyphCode, newGlyphInfo, newBitmap, newGlyphLigKern, thisFont);
   };
 
+  // Glyph codes referenced by the old font (main code, ligatures and kernings) are
+  // translated through their code point, as added code points shift the glyph codes
+  // of this font.
+  auto toThisGlyphCode = [this, fromFont](GlyphCode glyphCode) -> GlyphCode {
+    return translate(fromFont->getUTF32(glyphCode));
+  };
+
   stream << "Building Font Modifications File:" << Qt::endl << Qt::endl;
 
-  int modifCount = 0;
+  // The glyphs of each face are compared to the old font in parallel, one face per task.
+  // Fingerprints are compared first, glyphs with the same fingerprint being then
+  // compared in full. They can only be compared between UTF32 fonts (see
+  // glyphFingerprint()). The modifications are then retrieved in the faces order.
+
+  enum class GlyphStatus : uint8_t { UNCHANGED, MODIFIED, ABSENT };
+
+  struct FaceDiff {
+    Face                    *face;
+    Face                    *fromFace;
+    std::vector<GlyphStatus> status;
+  };
+
+  bool useFingerprints = (preamble_.bits.fontFormat == FontFormat::UTF32) &&
+                         (fromFont->preamble_.bits.fontFormat == FontFormat::UTF32);
+
+  std::vector<FaceDiff> faceDiffs;
   for (auto &face : faces_) {
     FacePtr fromFace = fromFont->findFace(face->header->pointSize);
-    if (fromFace != nullptr) {
-      for (uint16_t glyphCode = 0; glyphCode < face->header->glyphCount; glyphCode++) {
-        char32_t glyphCodePoint = getUTF32(glyphCode);
-        uint16_t fromGlyphCode  = fromFont->translate(glyphCodePoint);
-        if ((fromGlyphCode != SPACE_CODE) && (fromGlyphCode != NO_GLYPH_CODE)) {
-          if (!((*face->glyphs[glyphCode] == *fromFace->glyphs[fromGlyphCode]) &&
-                (*face->bitmaps[glyphCode] == *fromFace->bitmaps[fromGlyphCode]) &&
-                (*face->glyphsLigKern[glyphCode] == *fromFace->glyphsLigKern[fromGlyphCode]))) {
-
-            saveGlyph(faceIdx, face, glyphCode);
-            modifCount += 1;
-          }
-        } else if ((glyphCodePoint >= 0xE000) && (glyphCodePoint <= 0xF8FF)) {
-          saveGlyph(faceIdx, face, glyphCode);
+    faceDiffs.push_back(FaceDiff{.face = face.get(), .fromFace = fromFace.get(), .status = {}});
+  }
+
+  auto runTasks = [](int taskCount, const std::function<void(int taskIdx)> &task) {
+    if (taskCount == 0) return;
+
+    std::atomic<int> nextTask = 0;
+
+    auto worker = [&]() {
+      int taskIdx;
+      while ((taskIdx = nextTask++) < taskCount) {
+        task(taskIdx);
+      }
+    };
+
+    int threadCount = std::clamp<int>(std::thread::hardware_concurrency(), 1, taskCount);
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+
+  // Fingerprints are cached in their face: each face is given to a single task.
+  if (useFingerprints) {
+    std::vector<std::pair<const IBMFFontMod *, Face *>> faceTasks;
+    std::set<Face *>                                    taskFaces;
+    for (auto &faceDiff : faceDiffs) {
+      if (faceDiff.fromFace == nullptr) continue;
+      if (taskFaces.insert(faceDiff.face).second) faceTasks.push_back({this, faceDiff.face});
+      if (taskFaces.insert(faceDiff.fromFace).second) {
+        faceTasks.push_back({fromFont.get(), faceDiff.fromFace});
+      }
+    }
+    runTasks(faceTasks.size(), [&faceTasks](int taskIdx) {
+      auto [font, face] = faceTasks[taskIdx];
+      for (int glyphIdx = 0; glyphIdx < face->glyphs.size(); glyphIdx++) {
+        font->fingerprint(*face, glyphIdx);
+      }
+    });
+  }
+
+  // Only read accesses from now on, the fingerprints being all available
+  runTasks(faceDiffs.size(), [&](int taskIdx) {
+    Face &face     = *faceDiffs[taskIdx].face;
+    Face *fromFace = faceDiffs[taskIdx].fromFace;
+    if (fromFace == nullptr) return;
+
+    auto &status = faceDiffs[taskIdx].status;
+    status.assign(face.header->glyphCount, GlyphStatus::UNCHANGED);
+
+    for (uint16_t glyphCode = 0; glyphCode < face.header->glyphCount; glyphCode++) {
+      char32_t glyphCodePoint = getUTF32(glyphCode);
+      uint16_t fromGlyphCode  = fromFont->translate(glyphCodePoint);
+      if ((fromGlyphCode != SPACE_CODE) && (fromGlyphCode != NO_GLYPH_CODE)) {
+        if (useFingerprints &&
+            (face.fingerprints[glyphCode] != fromFace->fingerprints[fromGlyphCode])) {
+          status[glyphCode] = GlyphStatus::MODIFIED;
+          continue;
+        }
+
+        GlyphInfo fromGlyphInfo = fromFace->glyphs[fromGlyphCode];
+        fromGlyphInfo.mainCode  = toThisGlyphCode(fromGlyphInfo.mainCode);
+
+        GlyphLigKern fromGlyphLigKern = *fromFont->getLigKern(*fromFace, fromGlyphCode, false);
+        for (auto &l : fromGlyphLigKern.ligSteps) {
+          l.nextGlyphCode        = toThisGlyphCode(l.nextGlyphCode);
+          l.replacementGlyphCode = toThisGlyphCode(l.replacementGlyphCode);
+        }
+        for (auto &k : fromGlyphLigKern.kernSteps) {
+          k.nextGlyphCode = toThisGlyphCode(k.nextGlyphCode);
+        }
+
+        if (!((face.glyphs[glyphCode] == fromGlyphInfo) &&
+              (*getBitmap(face, glyphCode, false) ==
+               *fromFont->getBitmap(*fromFace, fromGlyphCode, false)) &&
+              (*getLigKern(face, glyphCode, false) == fromGlyphLigKern))) {
+          status[glyphCode] = GlyphStatus::MODIFIED;
+        }
+      } else if ((glyphCodePoint >= 0xE000) && (glyphCodePoint <= 0xF8FF)) {
+        status[glyphCode] = GlyphStatus::MODIFIED;
+      } else {
+        status[glyphCode] = GlyphStatus::ABSENT;
+      }
+    }
+  });
+
+  int modifCount = 0;
+  for (auto &faceDiff : faceDiffs) {
+    if (faceDiff.fromFace != nullptr) {
+      for (uint16_t glyphCode = 0; glyphCode < faceDiff.status.size(); glyphCode++) {
+        if (faceDiff.status[glyphCode] == GlyphStatus::MODIFIED) {
+          saveGlyph(faceIdx, faces_[faceIdx], glyphCode);
           modifCount += 1;
-        } else {
+        } else if (faceDiff.status[glyphCode] == GlyphStatus::ABSENT) {
           stream << "Codepoint " << +getUTF32(glyphCode) << " not present in Old Font." << Qt::endl;
         }
       }
     } else {
-      stream << "Face point " << +face->header->pointSize << " not present in Old Font."
+      stream << "Face point " << +faceDiff.face->header->pointSize << " not present in Old Font."
              << Qt::endl;
     }
     faceIdx += 1;
@@ -1478,39 +2113,6 @@ auto IBMFFontMod::buildModificationsFrom(QTextStream &stream, IBMFFontModPtr fro
   return backup;
 }
 
-auto IBMFFontMod::createBundleCodePointEntry(char16_t cPoint) -> void {
-
-  // Find in which bundle the codePoint must be integrated
-  int bundleIdx = 0;
-  while (bundleIdx < codePointBundles_.size()) {
-    if (codePointBundles_[bundleIdx].firstCodePoint > cPoint) {
-      break;
-    }
-    bundleIdx += 1;
-  }
-  if (bundleIdx > 0) {
-    bundleIdx -= 1;
-  }
-
-  // Check if the codePoint can be integrated to this bundle. If yes, do it. If no
-  // add a new bundle
-
-  if (codePointBundles_[bundleIdx].lastCodePoint == (cPoint - 1)) {
-    codePointBundles_[bundleIdx].lastCodePoint = cPoint;
-  } else {
-    CodePointBundle newBundle{.firstCodePoint = cPoint, .lastCodePoint = cPoint};
-    codePointBundles_.insert(codePointBundles_.begin() + (bundleIdx + 1), newBundle);
-    planes_[0].entriesCount += 1;
-    for (int i = 1; i < 4; i++) {
-      planes_[i].codePointBundlesIdx += 1;
-    }
-  }
-
-  for (int i = 1; i < 4; i++) {
-    planes_[i].firstGlyphCode += 1;
-  }
-}
-
 auto IBMFFontMod::addCodePoint(IBMFFontModPtr backup, IBMFFontModPtr font, char32_t codePoint)
     -> char32_t {
 
@@ -1528,39 +2130,172 @@ auto IBMFFontMod::addCodePoint(IBMFFontModPtr backup, IBMFFontModPtr font, char3
     }
   }
 
-  char16_t cPoint = static_cast<char16_t>(codePoint);
+  addCodePoints(backup, font, {codePoint});
 
-  createBundleCodePointEntry(cPoint);
+  return codePoint;
+}
 
-  // Create new empty character in each face
+/// @brief Add a set of plane 0 code points to the font, with an empty glyph in each face
+///
+/// The bundles of plane 0 are rebuilt once with the new code points, and each face gets its
+/// glyphs arrays rebuilt in a single pass. The glyph codes of the existing glyphs that
+/// follow a new code point are shifted: all glyph codes used by the lig/kern programs and
+/// the main codes are remapped accordingly.
+///
+/// @param backup The font modifications, receiving the new glyphs.
+/// @param font The font itself, as a shared pointer.
+/// @param codePoints The code points to add. Those already present in the font are ignored.
+/// @return The number of code points added.
+auto IBMFFontMod::addCodePoints(IBMFFontModPtr backup, IBMFFontModPtr font,
+                                const std::set<char32_t> &codePoints) -> int {
+
+  std::vector<char16_t> newCodePoints;
+  for (auto codePoint : codePoints) {
+    if ((codePoint <= 0xFFFF) && (toGlyphCode(codePoint) == NO_GLYPH_CODE)) {
+      newCodePoints.push_back(static_cast<char16_t>(codePoint));
+    }
+  }
+  if (newCodePoints.empty() || (planes_.size() < 4)) return 0;
+
+  modificationCount_++;
+
+  // ----- Plane 0 bundles and glyph codes remapping -----
+  //
+  // The glyph codes of plane 0 follow its code points order. The existing code points
+  // and the new ones are merged in that order to get the final glyph codes.
+
+  int oldGlyphCount = glyphCodePoints_.size();
+  int addedCount    = newCodePoints.size();
+  int firstGCode    = planes_[0].firstGlyphCode;
+  int endGCode      = firstGCode; // end of plane 0 glyph codes
+
+  for (int bundleIdx = planes_[0].codePointBundlesIdx;
+       bundleIdx < planes_[0].codePointBundlesIdx + planes_[0].entriesCount; bundleIdx++) {
+    endGCode += codePointBundles_[bundleIdx].lastCodePoint -
+                codePointBundles_[bundleIdx].firstCodePoint + 1;
+  }
+
+  std::vector<int>             remap(oldGlyphCount);
+  std::vector<GlyphCode>       newGlyphCodes;
+  std::vector<CodePointBundle> bundles;
+
+  auto addToBundles = [&bundles](char16_t u16) {
+    if (!bundles.empty() && (bundles.back().lastCodePoint == (u16 - 1))) {
+      bundles.back().lastCodePoint = u16;
+    } else {
+      bundles.push_back(CodePointBundle{.firstCodePoint = u16, .lastCodePoint = u16});
+    }
+  };
+
+  for (int gCode = 0; gCode < firstGCode; gCode++) {
+    remap[gCode] = gCode;
+  }
+
+  int  gCode  = firstGCode;
+  int  oldIdx = firstGCode;
+  auto newCp  = newCodePoints.begin();
+  while ((oldIdx < endGCode) || (newCp != newCodePoints.end())) {
+    if ((newCp == newCodePoints.end()) ||
+        ((oldIdx < endGCode) && (glyphCodePoints_[oldIdx] < *newCp))) {
+      addToBundles(static_cast<char16_t>(glyphCodePoints_[oldIdx]));
+      remap[oldIdx++] = gCode++;
+    } else {
+      addToBundles(*newCp++);
+      newGlyphCodes.push_back(gCode++);
+    }
+  }
+
+  for (int gCode = endGCode; gCode < oldGlyphCount; gCode++) {
+    remap[gCode] = gCode + addedCount;
+  }
+
+  int bundleCountDelta = bundles.size() - planes_[0].entriesCount;
+  codePointBundles_.erase(codePointBundles_.begin() + planes_[0].codePointBundlesIdx,
+                          codePointBundles_.begin() + planes_[0].codePointBundlesIdx +
+                              planes_[0].entriesCount);
+  codePointBundles_.insert(codePointBundles_.begin() + planes_[0].codePointBundlesIdx,
+                           bundles.begin(), bundles.end());
+  planes_[0].entriesCount = bundles.size();
+  for (int i = 1; i < 4; i++) {
+    planes_[i].codePointBundlesIdx += bundleCountDelta;
+    planes_[i].firstGlyphCode      += addedCount;
+  }
+
+  buildCodePointIndex();
+
+  auto remapCode = [&remap](GlyphCode glyphCode) -> GlyphCode {
+    return (glyphCode < remap.size()) ? remap[glyphCode] : glyphCode;
+  };
+
+  // ----- Faces glyphs arrays -----
 
-  int faceIdx = 0;
   for (auto &face : faces_) {
-    GlyphCode glyphCode       = translate(codePoint);
-    auto      newGlyphInfo    = GlyphInfoPtr(new GlyphInfo{
-                .bitmapWidth      = 0,
-                .bitmapHeight     = 0,
-                .horizontalOffset = 0,
-                .verticalOffset   = 0,
-                .packetLength     = 0,
-                .advance          = static_cast<FIX16>(1 << 6),
-                .rleMetrics =
-            {.dynF = 0, .firstIsBlack = 0, .beforeAddedOptKern = 0, .afterAddedOptKern = 0},
-                .ligKernPgmIndex = 255,
-                .mainCode        = glyphCode
-    });
-    auto      newBitmap       = BitmapPtr(new Bitmap());
-    auto      newGlyphLigKern = GlyphLigKernPtr(new GlyphLigKern);
+    int newCount = face->glyphs.size() + addedCount;
+
+    std::vector<GlyphInfo>       glyphs(newCount);
+    std::vector<BitmapPtr>       bitmaps(newCount);
+    std::vector<GlyphLigKernPtr> glyphsLigKern(newCount);
+    std::vector<PixelPoolIndex>  pixelsPoolIndexes(face->pixelsPoolIndexes.empty() ? 0 : newCount,
+                                                   MODIFIED_BITMAP);
+
+    for (int oldIdx = 0; oldIdx < face->glyphs.size(); oldIdx++) {
+      int newIdx              = remapCode(oldIdx);
+      glyphs[newIdx]          = face->glyphs[oldIdx];
+      glyphs[newIdx].mainCode = remapCode(glyphs[newIdx].mainCode);
+      bitmaps[newIdx]         = face->bitmaps[oldIdx];
+      if (!pixelsPoolIndexes.empty()) pixelsPoolIndexes[newIdx] = face->pixelsPoolIndexes[oldIdx];
+
+      // The programs still in ligKernSteps refer to the old glyph codes: all programs
+      // are retrieved to be remapped.
+      auto glyphLigKern = GlyphLigKernPtr(new GlyphLigKern(*getLigKern(*face, oldIdx, false)));
+      for (auto &ligStep : glyphLigKern->ligSteps) {
+        ligStep.nextGlyphCode        = remapCode(ligStep.nextGlyphCode);
+        ligStep.replacementGlyphCode = remapCode(ligStep.replacementGlyphCode);
+      }
+      for (auto &kernStep : glyphLigKern->kernSteps) {
+        kernStep.nextGlyphCode = remapCode(kernStep.nextGlyphCode);
+      }
+      glyphsLigKern[newIdx] = glyphLigKern;
+    }
+
+    for (auto glyphCode : newGlyphCodes) {
+      glyphs[glyphCode] = GlyphInfo{
+          .bitmapWidth      = 0,
+          .bitmapHeight     = 0,
+          .horizontalOffset = 0,
+          .verticalOffset   = 0,
+          .packetLength     = 0,
+          .advance          = static_cast<FIX16>(1 << 6),
+          .rleMetrics =
+              {.dynF = 0, .firstIsBlack = 0, .beforeAddedOptKern = 0, .afterAddedOptKern = 0},
+          .ligKernPgmIndex = 255,
+          .mainCode        = glyphCode};
+      bitmaps[glyphCode]       = BitmapPtr(new Bitmap());
+      glyphsLigKern[glyphCode] = GlyphLigKernPtr(new GlyphLigKern);
+    }
+
+    face->glyphs              = std::move(glyphs);
+    face->bitmaps             = std::move(bitmaps);
+    face->glyphsLigKern       = std::move(glyphsLigKern);
+    face->pixelsPoolIndexes   = std::move(pixelsPoolIndexes);
+    face->header->glyphCount += addedCount;
+    face->fingerprints.clear();
+  }
 
-    face->header->glyphCount += 1;
-    face->glyphs.insert(face->glyphs.begin() + glyphCode, newGlyphInfo);
-    face->bitmaps.insert(face->bitmaps.begin() + glyphCode, newBitmap);
-    face->glyphsLigKern.insert(face->glyphsLigKern.begin() + glyphCode, newGlyphLigKern);
+  for (auto &decodedBitmap : decodedBitmaps_) {
+    decodedBitmap.second = remapCode(decodedBitmap.second);
+  }
 
-    backup->saveGlyph(faceIdx, glyphCode, newGlyphInfo, newBitmap, newGlyphLigKern, font);
+  // ----- The new glyphs are part of the font modifications -----
 
+  int faceIdx = 0;
+  for (auto &face : faces_) {
+    for (auto glyphCode : newGlyphCodes) {
+      backup->saveGlyph(faceIdx, glyphCode, GlyphInfoPtr(new GlyphInfo(face->glyphs[glyphCode])),
+                        face->bitmaps[glyphCode], face->glyphsLigKern[glyphCode], font);
+    }
     faceIdx += 1;
   }
 
-  return codePoint;
+  return addedCount;
 }
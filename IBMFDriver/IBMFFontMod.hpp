@@ -2,8 +2,11 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "IBMFDefs.hpp"
@@ -11,6 +14,7 @@
 using namespace IBMFDefs;
 
 #include <QDataStream>
+#include <QFile>
 #include <QTextStream>
 
 #include "../Kerning/kerningModel.h"
@@ -38,28 +42,59 @@ typedef std::shared_ptr<IBMFFontMod> IBMFFontModPtr;
 class IBMFFontMod {
 public:
   struct Face {
-    FaceHeaderPtr                header;
-    std::vector<GlyphInfoPtr>    glyphs; // Not used with BAKCUP format
-    std::vector<BitmapPtr>       bitmaps;
+    FaceHeaderPtr          header;
+    std::vector<GlyphInfo> glyphs; // Not used with BAKCUP format
+    // Bitmaps retrieved from a font file are decoded on first access (see getBitmap()).
+    // A nullptr entry means that the bitmap must be extracted from the pixels pool.
+    std::vector<BitmapPtr> bitmaps;
+    // Lig/kern programs retrieved from a font file are extracted on first access (see
+    // getLigKern()). A nullptr entry means that the program must be extracted from
+    // ligKernSteps, starting at the glyph's ligKernPgmIndex.
     std::vector<GlyphLigKernPtr> glyphsLigKern; // Specific to each glyph
-    // used ontly at save and load time
-    std::vector<RLEBitmapPtr> compressedBitmaps; // Todo: maybe unused at the end
 
-    // used only at save time
-    std::vector<LigKernStep> ligKernSteps; // The complete list of lig/kerns
+    // RLE packets as found in the font file or as generated by the last save. The packet
+    // of a glyph starts at pixelsPool[pixelsPoolIndexes[glyphIdx]]. A MODIFIED_BITMAP index
+    // means that the bitmaps entry has been modified and is the only source of the glyph:
+    // only these glyphs (or all of them when the face has no pool) are encoded at save time.
+    const uint8_t              *pixelsPool = nullptr;
+    std::vector<PixelPoolIndex> pixelsPoolIndexes;
+    // Owner of pixelsPool once the face is saved, nullptr while the pool is located in the
+    // font file content. A pool is never modified: it is shared with the snapshots.
+    std::shared_ptr<const Pixels> savedPixelsPool;
+    uint32_t                      savedPixelsPoolPos = 0; // Offset in the saved file
+
+    // Fingerprint of each glyph (see fingerprint()), 0 when not computed yet. The entry
+    // of a glyph must be reset each time its metrics, bitmap or lig/kern program change.
+    std::vector<uint64_t> fingerprints;
+
+    // The complete list of lig/kerns, as found in the font file or generated by the last save
+    std::vector<LigKernStep> ligKernSteps;
 
     // Only used with BACKUP format
     std::vector<BackupGlyphInfoPtr>    backupGlyphs;
     std::vector<BackupGlyphLigKernPtr> backupGlyphsLigKern;
+    // Index in backupGlyphs of each code point, kept in sync with it (see findGlyphIndex())
+    std::unordered_map<char32_t, int>  backupGlyphIndexes;
   };
 
   typedef std::shared_ptr<Face> FacePtr;
 
-  IBMFFontMod(uint8_t *memoryFont, uint32_t size) : memory_(memoryFont), memoryLength_(size) {
+  // Called by save() with the number of faces written so far. Returns false to cancel.
+  typedef std::function<bool(int savedFaceCount, int faceCount)> SaveProgress;
+
+  // The font content is copied, as the glyphs' RLE packets are accessed in place.
+  IBMFFontMod(uint8_t *memoryFont, uint32_t size)
+      : memoryContent_(memoryFont, memoryFont + size), memoryLength_(size) {
+    memory_      = memoryContent_.data();
     initialized_ = load();
     lastError_   = 0;
   }
 
+  // The font file is memory mapped. The glyphs' RLE packets are accessed in place, the
+  // file content being never copied, except to save the font over it (see releaseFile()).
+  // Once saved, the font maps the file written (see snapshotSaved()).
+  IBMFFontMod(const QString &filePath);
+
   // The following constructor is used ONLY for importing other font formats
   // or to create a BACKUP font format.
   // A specific load method must then be used to retrieve the font information
@@ -83,6 +118,10 @@ public:
     return font;
   }
 
+  static auto snapshotOf(IBMFFontModPtr font, const QString &filePath = QString())
+      -> IBMFFontModPtr;
+  auto snapshotSaved(IBMFFontModPtr snapshot, const QString &filePath = QString()) -> bool;
+
   auto clear() -> void;
 
   inline auto getPreamble() const -> Preamble { return preamble_; }
@@ -111,15 +150,23 @@ public:
   auto findGlyphIndex(FacePtr face, char32_t codePoint) -> int;
 
   auto ligKern(int faceIndex, const GlyphCode glyphCode1, GlyphCode *glyphCode2, FIX16 *kern,
-               bool *kernPairPresent, GlyphLigKernPtr bypassLigKern = nullptr) const -> bool;
+               bool *kernPairPresent, GlyphLigKernConstPtr bypassLigKern = nullptr) const
+      -> bool;
+  // A copy of the glyph, to be modified by the caller
   auto getGlyph(int faceIndex, int glyphCode, GlyphInfoPtr &glyphInfo, BitmapPtr &bitmap,
                 GlyphLigKernPtr &glyphLigKern) const -> bool;
+  // The glyph as kept in the font, shared without copy, for display purposes
+  auto viewGlyph(int faceIndex, int glyphCode, GlyphInfo &glyphInfo, BitmapConstPtr &bitmap,
+                 GlyphLigKernConstPtr &glyphLigKern) const -> bool;
   auto saveFaceHeader(int faceIndex, FaceHeader &face_header) -> bool;
   // The font parameter is only used with the BACKUP format
   auto saveGlyph(int faceIndex, int glyphCode, GlyphInfoPtr newGlyphInfo, BitmapPtr newBitmap,
                  GlyphLigKernPtr glyphLigKern, IBMFFontModPtr font = nullptr) -> bool;
   auto convertToOneBit(const Bitmap &bitmapHeightBits, BitmapPtr *bitmapOneBit) -> bool;
-  auto save(QDataStream &out) -> bool;
+  // With maxCompression, the smallest encoding of every glyph bitmap is looked for. The
+  // bytes saved in each face are then reported in log if present.
+  auto save(QDataStream &out, SaveProgress progress = nullptr, bool maxCompression = false,
+            QTextStream *log = nullptr) -> bool;
   auto translate(char32_t codePoint) const -> GlyphCode;
   auto getUTF32(GlyphCode glyphCode) const -> char32_t;
   auto toGlyphCode(char32_t codePoint) const -> GlyphCode;
@@ -129,13 +176,12 @@ public:
   auto showLigKerns(QTextStream &stream, GlyphLigKernPtr lk) const -> void;
   auto showBackupGlyphInfo(QTextStream &stream, GlyphCode i, const BackupGlyphInfoPtr g) const
       -> void;
-  auto showGlyphInfo(QTextStream &stream, GlyphCode i, const GlyphInfoPtr g) const -> void;
+  auto showGlyphInfo(QTextStream &stream, GlyphCode i, const GlyphInfo &g) const -> void;
   auto showFace(QTextStream &stream, FacePtr face, bool withBitmaps) const -> void;
   auto showCodePointBundles(QTextStream &stream, int firstIdx, int count) const -> void;
   auto showPlanes(QTextStream &stream) const -> void;
   auto showFont(QTextStream &stream, QString fontName, bool withBitmaps = false) const -> void;
 
-  auto createBundleCodePointEntry(char16_t cPoint) -> void;
   void recomputeLigatures();
   auto importModificationsFrom(QTextStream &stream, QString fontName, QString fileName,
                                IBMFFontModPtr fromBackup, IBMFFontModPtr toBackup,
@@ -144,6 +190,8 @@ public:
       -> IBMFFontModPtr;
 
   auto addCodePoint(IBMFFontModPtr backup, IBMFFontModPtr font, char32_t codePoint = 0) -> char32_t;
+  auto addCodePoints(IBMFFontModPtr backup, IBMFFontModPtr font,
+                     const std::set<char32_t> &codePoints) -> int;
 
   auto glyphIsModified(int faceIdx, GlyphCode glyphCode, BitmapPtr &bitmap, GlyphInfoPtr &glyphInfo,
                        GlyphLigKernPtr &ligKern) const -> bool;
@@ -157,17 +205,77 @@ protected:
   std::vector<CodePointBundle> codePointBundles_;
   std::vector<FacePtr>         faces_;
 
+  // Code point lookup index of the UTF32 format, derived from planes_ and
+  // codePointBundles_. It must be rebuilt when they are modified.
+  auto buildCodePointIndex() -> void;
+  auto checkCodePointIndex(GlyphCode &glyphCode) const -> bool;
+
 private:
+  // Maximum number of lazily decoded bitmaps kept in memory. Modified bitmaps are not
+  // counted, as they are the only source of their content until the next save.
+  static constexpr int DECODED_BITMAPS_CACHE_SIZE = 8192;
+
+  static constexpr PixelPoolIndex MODIFIED_BITMAP = 0xFFFFFFFF;
+
+  // Number of glyphs given at once to an encoding thread at save time
+  static constexpr int ENCODING_CHUNK_SIZE = 64;
+
+  // Code point lookup index: the glyph code of the first code point of each bundle, the
+  // glyph code of every code point of plane 0 (NO_GLYPH_CODE if not in the font) and the
+  // code point of every glyph code.
+  std::vector<int>       bundlesFirstGlyphCode_;
+  std::vector<GlyphCode> bmpGlyphCodes_;
+  std::vector<char32_t>  glyphCodePoints_;
+
+  // A glyph bitmap as written at save time. The pixels are either in the current pixels
+  // pool of the face (unmodified glyph) or in data (newly encoded glyph).
+  struct RLEPacket {
+    uint8_t        dynF         = 14;
+    bool           firstIsBlack = false;
+    const uint8_t *pixels       = nullptr;
+    uint16_t       length       = 0;
+    int            saved        = 0; // bytes saved by maxCompression
+    Pixels         data;
+  };
+
   bool initialized_;
 
   std::vector<uint32_t> faceOffsets_;
 
-  uint8_t *memory_;
-  uint32_t memoryLength_;
+  QFile                mappedFile_;
+  std::vector<uint8_t> memoryContent_;
+  uint8_t             *memory_;
+  uint32_t             memoryLength_;
 
   int lastError_;
 
-  auto findList(std::vector<LigKernStep> &pgm, std::vector<LigKernStep> &list) const -> int;
+  // For a snapshot, the font it was taken from
+  IBMFFontModPtr source_;
+
+  // Incremented by each change of the font content. For a snapshot, the count of the font
+  // it was taken from at the time, to detect modifications done during its save.
+  uint64_t modificationCount_ = 0;
+
+  // Lazily decoded bitmaps, oldest first, candidates for eviction
+  mutable std::deque<std::pair<Face *, int>> decodedBitmaps_;
+
+  auto getBitmap(Face &face, int glyphIdx, bool keepIt = true) const -> BitmapPtr;
+  auto setBitmap(Face &face, int glyphIdx, BitmapPtr bitmap) -> void;
+  auto getLigKern(Face &face, int glyphIdx, bool keepIt = true) const -> GlyphLigKernPtr;
+  auto glyphFingerprint(const GlyphInfo &glyphInfo, const Bitmap &bitmap,
+                        const GlyphLigKern &glyphLigKern) const -> uint64_t;
+  auto fingerprint(Face &face, int glyphIdx) const -> uint64_t;
+  // Start indexes in a lig/kern steps list of the suffixes of its programs, by hash value
+  typedef std::unordered_multimap<uint64_t, int> LigKernSuffixes;
+
+  auto addSuffixes(const std::vector<LigKernStep> &list, int first, LigKernSuffixes &suffixes) const
+      -> void;
+  auto findList(const std::vector<LigKernStep> &pgm, const std::vector<LigKernStep> &list,
+                const LigKernSuffixes &suffixes) const -> int;
   auto prepareLigKernVectors() -> bool;
+  auto findBundle(int planeIdx, char16_t u16) const -> int;
+  auto encodeBitmaps(Face &face, std::vector<RLEPacket> &packets, bool maxCompression) -> bool;
+  auto releaseFile() -> void;
+  auto mapSavedFile(const QString &filePath) -> void;
   auto load() -> bool;
 };
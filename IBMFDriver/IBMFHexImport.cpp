@@ -1,160 +1,137 @@
 #include "IBMFHexImport.hpp"
 
-#include <iomanip>
-
-auto IBMFHexImport::readCodePoint(std::fstream &in, char32_t &codePoint, uint32_t &firstBytes)
-    -> bool {
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include <QFile>
+
+// Value of each hexadecimal digit character, -1 for all other characters
+static constexpr std::array<int8_t, 256> hexDigits = [] {
+  std::array<int8_t, 256> digits{};
+  for (auto &digit : digits) digit = -1;
+  for (int i = 0; i < 10; i++) digits['0' + i] = i;
+  for (int i = 0; i < 6; i++) {
+    digits['A' + i] = 10 + i;
+    digits['a' + i] = 10 + i;
+  }
+  return digits;
+}();
+
+// Parses the content of a .hex file in a single pass. Each line is made of a code point
+// and the glyph bytes, both in hexadecimal, separated by a colon. The selected glyphs are
+// added to hexGlyphs in the file order.
+auto IBMFHexImport::parseHex(const char *data, const char *end,
+                             SelectedBlockIndexesPtr &selectedBlockIndexes,
+                             HexGlyphs &hexGlyphs) const -> void {
+
+  auto digit = [](char ch) -> int8_t { return hexDigits[static_cast<uint8_t>(ch)]; };
+
+  hexGlyphs.reserve((end - data) / 40);
+
+  const char *p = data;
+  while (p < end) {
+    char32_t codePoint = 0;
+    int      length    = 0;
+    while ((p < end) && (digit(*p) >= 0)) {
+      codePoint = (codePoint << 4) + digit(*p++);
+      length += 1;
+    }
 
-  auto hex = [](char a) -> uint8_t { return ((a >= '0') && (a <= '9')) ? a - '0' : a - 'A' + 10; };
+    if ((length > 0) && (p < end) && (*p == ':')) {
+      p++;
 
-  if (in.eof()) return false;
+      HexGlyph hexGlyph = {.codePoint = codePoint, .byteWidth = 0, .bytes = {0}};
+      int      count    = 0; // Number of bytes found on the line
+      while (((p + 1) < end) && (digit(p[0]) >= 0) && (digit(p[1]) >= 0)) {
+        if (count < 32) hexGlyph.bytes[count] = (digit(p[0]) << 4) + digit(p[1]);
+        count += 1;
+        p += 2;
+      }
 
-  int i;
-  in >> std::hex >> i;
+      uint32_t firstBytes = (hexGlyph.bytes[0] << 24) + (hexGlyph.bytes[1] << 16) +
+                            (hexGlyph.bytes[2] << 8) + hexGlyph.bytes[3];
 
-  char ch;
-  in >> ch;
+      if (((codePoint >> 16) < 4) && // Only the first 4 planes are managed
+          charSelected(codePoint, selectedBlockIndexes, firstBytes)) {
+        if ((count == 16) || (count == 32)) {
+          hexGlyph.byteWidth = count / 16;
+          hexGlyphs.push_back(hexGlyph);
+        } else {
+          std::cout << "GNU Unifont Read Error!!!" << std::endl;
+        }
+      }
+    }
 
-  if (ch == ':') {
-    codePoint = static_cast<char32_t>(i);
-    char b1, b2, b3, b4;
-    in >> b1 >> b2 >> b3 >> b4;
-    firstBytes = (hex(b1) << 12) + (hex(b2) << 8) + (hex(b3) << 4) + hex(b4);
-    in >> b1 >> b2 >> b3 >> b4;
-    firstBytes = (firstBytes << 16) + (hex(b1) << 12) + (hex(b2) << 8) + (hex(b3) << 4) + hex(b4);
-    while (!in.eof() && (in.get() != '\n'))
-      ;
-    return true;
+    while ((p < end) && (*p != '\n')) p++;
+    p++;
   }
-  return false;
 }
 
-auto IBMFHexImport::readOneGlyph(std::fstream &in, char32_t &codePoint, BitmapPtr bitmap,
-                                 int8_t &vOffset) -> GlyphCode {
-  int  i;
-  auto hex = [](char a) -> uint8_t { return ((a >= '0') && (a <= '9')) ? a - '0' : a - 'A' + 10; };
-
-  in >> std::hex >> i;
-
-  char ch;
-  in >> ch;
-  if (ch == ':') {
-    codePoint           = static_cast<char32_t>(i);
-    GlyphCode glyphCode = toGlyphCode(codePoint);
-    if (glyphCode == NO_GLYPH_CODE) goto noCode;
-
-    std::vector<uint8_t> bytes;
-    while (!in.eof() && (in.get() != '\n')) {
-      in.unget();
-      char b1, b2;
-      in >> b1 >> b2;
-      bytes.push_back((hex(b1) << 4) + hex(b2));
-    }
+// Number of leading (most significant) and trailing zero bits of a non-zero 16 bits word
+static inline auto leadingZeros(uint16_t word) -> int {
+#if defined(__GNUC__)
+  return __builtin_clz(word) - 16;
+#else
+  int count = 0;
+  while ((word & 0x8000) == 0) {
+    word <<= 1;
+    count += 1;
+  }
+  return count;
+#endif
+}
 
-    int byteWidth  = (bytes.size() == 16) ? 1 : 2;
-    int byteHeight = 16;
+static inline auto trailingZeros(uint16_t word) -> int {
+#if defined(__GNUC__)
+  return __builtin_ctz(word);
+#else
+  int count = 0;
+  while ((word & 0x0001) == 0) {
+    word >>= 1;
+    count += 1;
+  }
+  return count;
+#endif
+}
 
-    if ((byteWidth * byteHeight) == bytes.size()) {
-      int firstRow, lastRow, firstCol, lastCol;
-      if (byteWidth == 1) {
-        for (firstRow = 0; firstRow < 16; firstRow++) {
-          if (bytes[firstRow] != 0) break;
-        }
-        if (firstRow >= 16) goto spaceCode;
-        for (lastRow = 15; lastRow >= 0; lastRow--) {
-          if (bytes[lastRow] != 0) break;
-        }
-        if (lastRow < 0) goto spaceCode; // Not really usefull...
-      } else {
-        for (firstRow = 0; firstRow < 16; firstRow++) {
-          if ((bytes[firstRow << 1] != 0) || (bytes[(firstRow << 1) + 1] != 0)) break;
-        }
-        if (firstRow >= 16) goto spaceCode;
-        for (lastRow = 15; lastRow >= 0; lastRow--) {
-          if ((bytes[lastRow << 1] != 0) || (bytes[(lastRow << 1) + 1] != 0)) break;
-        }
-        if (lastRow < 0) goto spaceCode; // Not really usefull...
-      }
+// Computes the bitmap of a glyph, cropped to its black pixels. Returns false if the glyph
+// is blank.
+auto IBMFHexImport::cropGlyph(const HexGlyph &hexGlyph, Bitmap &bitmap, int8_t &vOffset) const
+    -> bool {
 
-      if (byteWidth == 1) {
-        uint8_t mask = 0x80;
-        firstCol     = 0;
-        for (int j = 0; j < 7; j++) {
-          for (int i = firstRow; i <= lastRow; i++) {
-            if (bytes[i] & mask) goto end1;
-          }
-          mask >>= 1;
-          firstCol += 1;
-        }
-      end1:
-        mask    = 0x01;
-        lastCol = 7;
-        for (int j = 0; j < 7; j++) {
-          for (int i = firstRow; i <= lastRow; i++) {
-            if (bytes[i] & mask) goto end2;
-          }
-          mask <<= 1;
-          lastCol -= 1;
-        }
-      } else {
-        uint8_t mask = 0x80;
-        firstCol     = 0;
-        for (int j = 0; j < 15; j++) {
-          for (int i = firstRow; i <= lastRow; i++) {
-            if (bytes[(i << 1) + (j >> 3)] & mask) goto end3;
-          }
-          mask >>= 1;
-          if (mask == 0) mask = 0x80;
-          firstCol += 1;
-        }
-      end3:
-        mask    = 0x01;
-        lastCol = 15;
-        for (int j = 15; j >= 0; j--) {
-          for (int i = firstRow; i <= lastRow; i++) {
-            if (bytes[(i << 1) + (j >> 3)] & mask) goto end4;
-          }
-          mask <<= 1;
-          if (mask == 0) mask = 0x01;
-          lastCol -= 1;
-        }
-      }
+  // Each row as a 16 bits word, the leftmost pixel being the most significant bit
+  uint16_t rows[16];
+  uint16_t allRows = 0;
+  for (int row = 0; row < 16; row++) {
+    rows[row] = (hexGlyph.byteWidth == 1)
+                    ? (hexGlyph.bytes[row] << 8)
+                    : ((hexGlyph.bytes[row << 1] << 8) + hexGlyph.bytes[(row << 1) + 1]);
+    allRows |= rows[row];
+  }
+  if (allRows == 0) return false;
 
-    end2:
-    end4:
-      bitmap->dim   = Dim(lastCol - firstCol + 1, lastRow - firstRow + 1);
-      vOffset       = 14 - firstRow;
-
-      uint8_t *buff = bytes.data() + (firstRow * byteWidth);
-      for (int row = firstRow; row <= lastRow; row++) {
-        uint8_t mask = 0x80 >> (firstCol & 7);
-        for (int col = firstCol; col <= lastCol; col++) {
-          uint8_t pixel = ((buff[col >> 3] & mask) == 0) ? 0 : 0xFF;
-          bitmap->pixels.push_back(pixel);
-          mask >>= 1;
-          if (mask == 0) mask = 0x80;
-        }
-        buff += byteWidth;
-      }
+  int firstRow = 0;
+  while (rows[firstRow] == 0) firstRow++;
+  int lastRow = 15;
+  while (rows[lastRow] == 0) lastRow--;
 
-    } else {
-      std::cout << "GNU Unifont Read Error!!!" << std::endl;
-      return NO_GLYPH_CODE;
-    }
+  int firstCol = leadingZeros(allRows);
+  int lastCol  = 15 - trailingZeros(allRows);
 
-    return glyphCode;
-  } else {
+  bitmap.dim = Dim(lastCol - firstCol + 1, lastRow - firstRow + 1);
+  vOffset    = 14 - firstRow;
 
-  noCode:
-    while (!in.eof() && (in.get() != '\n'))
-      ;
-    return NO_GLYPH_CODE;
+  bitmap.pixels.resize(bitmap.dim.width * bitmap.dim.height);
 
-  spaceCode:
-    bitmap->dim = Dim(0, 0);
-    bitmap->pixels.clear();
-    vOffset = 0;
-    return SPACE_CODE;
+  auto pixel = bitmap.pixels.begin();
+  for (int row = firstRow; row <= lastRow; row++) {
+    uint16_t word = rows[row] << firstCol;
+    for (int col = firstCol; col <= lastCol; col++) {
+      *pixel++ = (word & 0x8000) ? 0xFF : 0;
+      word <<= 1;
+    }
   }
 
   return true;
@@ -177,79 +154,49 @@ auto IBMFHexImport::charSelected(char32_t ch, SelectedBlockIndexesPtr &selectedB
   return false;
 }
 
-auto IBMFHexImport::prepareCodePlanes(std::fstream &in, CharSelectionsPtr &charSelections) -> int {
-
-  uint16_t glyphCode = 0;
-
-  if (charSelections->size() == 1) {
-
-    for (int i = 0; i < 4; i++) { planes_.push_back(Plane({0, 0, 0})); }
-
-    SelectedBlockIndexesPtr selectedBlockIndexes = charSelections->at(0).selectedBlockIndexes;
-
-    bool     firstSelected                       = false;
-    char16_t currCodePoint                       = 0;
-    int      currPlaneIdx                        = 0;
-    int      currCodePointBundleIdx              = 0;
-    char32_t codePoint;
-    uint32_t firstBytes;
-
-    while (readCodePoint(in, codePoint, firstBytes)) {
-      if (charSelected(codePoint, selectedBlockIndexes, firstBytes)) {
-        int planeIdx = codePoint >> 16;
-        if (planeIdx < 4) { // Only the first 4 planes are managed
-          char16_t u16 = static_cast<char16_t>(codePoint & 0x0000FFFF);
-          if (!firstSelected) {
-            currCodePoint     = u16;
-            currPlaneIdx      = planeIdx;
-            planes_[planeIdx] = Plane{
-                .codePointBundlesIdx = static_cast<uint16_t>(codePointBundles_.size()),
-                .entriesCount        = 1,
-                .firstGlyphCode      = 0,
-            };
-            currCodePointBundleIdx = codePointBundles_.size();
-            CodePointBundle bundle = CodePointBundle({.firstCodePoint = u16, .lastCodePoint = u16});
-            codePointBundles_.push_back(bundle);
-            firstSelected = true;
-          } else {
-            if (planeIdx != currPlaneIdx) {
-              for (int idx = planeIdx + 1; idx <= currPlaneIdx; idx++) {
-                planes_[idx].codePointBundlesIdx = codePointBundles_.size();
-              }
-              planes_[planeIdx] =
-                  Plane{.codePointBundlesIdx = static_cast<uint16_t>(codePointBundles_.size()),
-                        .entriesCount        = 1,
-                        .firstGlyphCode      = glyphCode};
-              currCodePointBundleIdx = codePointBundles_.size();
-              CodePointBundle bundle =
-                  CodePointBundle({.firstCodePoint = u16, .lastCodePoint = u16});
-              codePointBundles_.push_back(bundle);
-              currCodePoint = u16;
-              currPlaneIdx  = planeIdx;
-            } else {
-              if (u16 == (currCodePoint + 1)) {
-                codePointBundles_[currCodePointBundleIdx].lastCodePoint = u16;
-              } else {
-                currCodePointBundleIdx = codePointBundles_.size();
-                CodePointBundle bundle =
-                    CodePointBundle({.firstCodePoint = u16, .lastCodePoint = u16});
-                codePointBundles_.push_back(bundle);
-                planes_[currPlaneIdx].entriesCount += 1;
-              }
-              currCodePoint = u16;
-            }
-          }
-        }
-        glyphCode += 1;
+// Builds the planes and code point bundles from the glyphs, sorted by code point. The glyph
+// code of each glyph is its index in hexGlyphs.
+auto IBMFHexImport::prepareCodePlanes(const HexGlyphs &hexGlyphs) -> int {
+
+  uint16_t glyphCode     = 0;
+  int      currPlaneIdx  = -1;
+  char16_t currCodePoint = 0;
+
+  planes_.resize(4);
+
+  for (auto &hexGlyph : hexGlyphs) {
+    int      planeIdx = hexGlyph.codePoint >> 16;
+    char16_t u16      = static_cast<char16_t>(hexGlyph.codePoint & 0x0000FFFF);
+
+    if (planeIdx != currPlaneIdx) {
+      // Planes without any code point before this one are set at the current position
+      while (currPlaneIdx < planeIdx) {
+        currPlaneIdx += 1;
+        planes_[currPlaneIdx] =
+            Plane{.codePointBundlesIdx = static_cast<uint16_t>(codePointBundles_.size()),
+                  .entriesCount        = 0,
+                  .firstGlyphCode      = glyphCode};
       }
+      codePointBundles_.push_back(CodePointBundle{.firstCodePoint = u16, .lastCodePoint = u16});
+      planes_[planeIdx].entriesCount = 1;
+    } else if (u16 == (currCodePoint + 1)) {
+      codePointBundles_.back().lastCodePoint = u16;
+    } else {
+      codePointBundles_.push_back(CodePointBundle{.firstCodePoint = u16, .lastCodePoint = u16});
+      planes_[planeIdx].entriesCount += 1;
     }
-    // Completes the info of planes not used
-    for (int idx = currPlaneIdx + 1; idx < 4; idx++) {
-      planes_[idx].codePointBundlesIdx = codePointBundles_.size();
-      planes_[idx].firstGlyphCode      = glyphCode;
-    }
+    currCodePoint = u16;
+    glyphCode += 1;
   }
 
+  // Completes the info of planes not used
+  for (int idx = currPlaneIdx + 1; idx < 4; idx++) {
+    planes_[idx] = Plane{.codePointBundlesIdx = static_cast<uint16_t>(codePointBundles_.size()),
+                         .entriesCount        = 0,
+                         .firstGlyphCode      = glyphCode};
+  }
+  buildCodePointIndex();
+
   return glyphCode;
 }
 
@@ -268,96 +215,141 @@ auto IBMFHexImport::loadHex(FontParametersPtr fontParameters) -> bool {
   // clang-format on
 
   CharSelectionsPtr sel = fontParameters->charSelections;
+  if (sel->size() != 1) return false;
 
-  std::fstream in;
-  QString      filename = (*sel)[0].filename;
-  in.open(filename.toStdString(), std::ios::in);
-
-  if (in.is_open()) {
+  // ----- Retrieve the selected glyphs, in a single pass over the file content -----
 
-    int glyphCount = prepareCodePlanes(in, fontParameters->charSelections);
+  QFile file((*sel)[0].filename);
+  if (!file.open(QIODevice::ReadOnly)) return false;
 
-    if (glyphCount <= 0) {
-      in.close();
-      return false;
+  HexGlyphs   hexGlyphs;
+  qint64      size = file.size();
+  const char *data = reinterpret_cast<const char *>(file.map(0, size));
+  QByteArray  content;
+  if (data == nullptr) { // The file cannot be mapped in memory: read it
+    content = file.readAll();
+    data    = content.constData();
+    size    = content.size();
+  }
+  parseHex(data, data + size, (*sel)[0].selectedBlockIndexes, hexGlyphs);
+  file.close();
+
+  // The glyph codes follow the code points order. When a code point is defined many
+  // times, the first definition is kept.
+  auto byCodePoint = [](const HexGlyph &a, const HexGlyph &b) { return a.codePoint < b.codePoint; };
+  if (!std::is_sorted(hexGlyphs.begin(), hexGlyphs.end(), byCodePoint)) {
+    std::stable_sort(hexGlyphs.begin(), hexGlyphs.end(), byCodePoint);
+  }
+  hexGlyphs.erase(std::unique(hexGlyphs.begin(), hexGlyphs.end(),
+                              [](const HexGlyph &a, const HexGlyph &b) {
+                                return a.codePoint == b.codePoint;
+                              }),
+                  hexGlyphs.end());
+
+  // ----- Build Code Planes structures -----
+
+  int glyphCount = prepareCodePlanes(hexGlyphs);
+
+  if (glyphCount <= 0) return false;
+
+  FacePtr face = FacePtr(new Face);
+  face->glyphs.reserve(glyphCount);
+  face->bitmaps.resize(glyphCount);
+  face->glyphsLigKern.reserve(glyphCount);
+
+  // ----- Crop the glyphs -----
+
+  // The glyphs are independent from each other: they are cropped by chunks in parallel,
+  // each result being put at its glyph code position.
+
+  std::vector<int8_t> vOffsets(glyphCount);
+  int                 chunkCount = (glyphCount + CROPPING_CHUNK_SIZE - 1) / CROPPING_CHUNK_SIZE;
+  std::atomic<int>    nextChunk  = 0;
+
+  auto worker = [&]() {
+    int chunkIdx;
+    while ((chunkIdx = nextChunk++) < chunkCount) {
+      int first = chunkIdx * CROPPING_CHUNK_SIZE;
+      int last  = std::min(first + CROPPING_CHUNK_SIZE, glyphCount);
+      for (int glyphCode = first; glyphCode < last; glyphCode++) {
+        auto bitmap = BitmapPtr(new Bitmap());
+        if (!cropGlyph(hexGlyphs[glyphCode], *bitmap, vOffsets[glyphCode])) {
+          bitmap->dim         = Dim(0, 0);
+          vOffsets[glyphCode] = 0;
+        }
+        face->bitmaps[glyphCode] = bitmap;
+      }
     }
+  };
 
-    FacePtr face = FacePtr(new Face);
-
-    in.close();
-    in.open(filename.toStdString(), std::ios::in);
-
-    while (!in.eof()) {
-      char32_t  codePoint;
-      auto      bitmap = BitmapPtr(new Bitmap());
-      int8_t    vOffset;
-      GlyphCode glyphCode;
-
-      if ((glyphCode = readOneGlyph(in, codePoint, bitmap, vOffset)) != NO_GLYPH_CODE) {
-
-        face->bitmaps.push_back(bitmap);
+  int threadCount = std::clamp<int>(std::thread::hardware_concurrency(), 1, chunkCount);
 
-        GlyphLigKernPtr glyphLigKern = GlyphLigKernPtr(new GlyphLigKern);
+  std::vector<std::thread> threads;
+  for (int i = 1; i < threadCount; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
 
-        // Create ligatures for the glyph if available
-        // Ensure that both next and replacement glyph codes are present in the
-        // resulting IBMF font
-        char32_t firstChar = getUTF32(glyphCode);
-        for (auto &ligature : ligatures) {
-          if (ligature.firstChar == firstChar) {
-            GlyphCode nextGlyphCode        = toGlyphCode(ligature.nextChar);
-            GlyphCode replacementGlyphCode = toGlyphCode(ligature.replacement);
-            if ((nextGlyphCode != NO_GLYPH_CODE) && (replacementGlyphCode != NO_GLYPH_CODE)) {
-              glyphLigKern->ligSteps.push_back(GlyphLigStep{
-                  .nextGlyphCode = nextGlyphCode, .replacementGlyphCode = replacementGlyphCode});
-            }
-          }
+  for (GlyphCode glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
+    BitmapPtr bitmap  = face->bitmaps[glyphCode];
+    int8_t    vOffset = vOffsets[glyphCode];
+
+    GlyphLigKernPtr glyphLigKern = GlyphLigKernPtr(new GlyphLigKern);
+
+    // Create ligatures for the glyph if available
+    // Ensure that both next and replacement glyph codes are present in the
+    // resulting IBMF font
+    char32_t firstChar = hexGlyphs[glyphCode].codePoint;
+    for (auto &ligature : ligatures) {
+      if (ligature.firstChar == firstChar) {
+        GlyphCode nextGlyphCode        = toGlyphCode(ligature.nextChar);
+        GlyphCode replacementGlyphCode = toGlyphCode(ligature.replacement);
+        if ((nextGlyphCode != NO_GLYPH_CODE) && (replacementGlyphCode != NO_GLYPH_CODE)) {
+          glyphLigKern->ligSteps.push_back(GlyphLigStep{
+              .nextGlyphCode = nextGlyphCode, .replacementGlyphCode = replacementGlyphCode});
         }
-
-        face->glyphsLigKern.push_back(glyphLigKern);
-
-        // ----- Glyph Info -----
-
-        GlyphInfoPtr glyphInfo = GlyphInfoPtr(new GlyphInfo(GlyphInfo{
-            .bitmapWidth      = static_cast<uint8_t>(bitmap->dim.width),
-            .bitmapHeight     = static_cast<uint8_t>(bitmap->dim.height),
-            .horizontalOffset = static_cast<int8_t>(0),
-            .verticalOffset   = static_cast<int8_t>(vOffset),
-            .packetLength     = static_cast<uint16_t>(bitmap->dim.width * bitmap->dim.height),
-            .advance          = static_cast<FIX16>((bitmap->dim.width + 1) << 6),
-            .rleMetrics       = RLEMetrics{.dynF               = 0,
-                                           .firstIsBlack       = false,
-                                           .beforeAddedOptKern = 0,
-                                           .afterAddedOptKern  = 0},
-            .ligKernPgmIndex  = 0, // completed at save time
-            .mainCode         = glyphCode  // No composite management (for now)
-        }));
-
-        face->glyphs.push_back(glyphInfo);
       }
     }
 
-    in.close();
-
-    // ----- Face Header -----
-
-    face->header = FaceHeaderPtr(new FaceHeader({
-        .pointSize        = 10,
-        .lineHeight       = static_cast<uint8_t>(16),
-        .dpi              = static_cast<uint16_t>(75),
-        .xHeight          = static_cast<FIX16>(8 << 6),
-        .emSize           = static_cast<FIX16>(10 << 6),
-        .slantCorrection  = 0, // not available for FreeType
-        .descenderHeight  = static_cast<uint8_t>(2),
-        .spaceSize        = 5,
-        .glyphCount       = static_cast<uint16_t>(glyphCount),
-        .ligKernStepCount = 0, // will be set at save time
-        .pixelsPoolSize   = 0, // will be set at save time
-    }));
-    faces_.push_back(std::move(face));
-
-    return true;
+    face->glyphsLigKern.push_back(glyphLigKern);
+
+    // ----- Glyph Info -----
+
+    face->glyphs.push_back(GlyphInfo{
+        .bitmapWidth      = static_cast<uint8_t>(bitmap->dim.width),
+        .bitmapHeight     = static_cast<uint8_t>(bitmap->dim.height),
+        .horizontalOffset = static_cast<int8_t>(0),
+        .verticalOffset   = static_cast<int8_t>(vOffset),
+        .packetLength     = static_cast<uint16_t>(bitmap->dim.width * bitmap->dim.height),
+        .advance          = static_cast<FIX16>((bitmap->dim.width + 1) << 6),
+        .rleMetrics       = RLEMetrics{.dynF               = 0,
+                                       .firstIsBlack       = false,
+                                       .beforeAddedOptKern = 0,
+                                       .afterAddedOptKern  = 0},
+        .ligKernPgmIndex  = 0,        // completed at save time
+        .mainCode         = glyphCode // No composite management (for now)
+    });
   }
 
-  return false;
+  // ----- Face Header -----
+
+  face->header = FaceHeaderPtr(new FaceHeader({
+      .pointSize        = 10,
+      .lineHeight       = static_cast<uint8_t>(16),
+      .dpi              = static_cast<uint16_t>(75),
+      .xHeight          = static_cast<FIX16>(8 << 6),
+      .emSize           = static_cast<FIX16>(10 << 6),
+      .slantCorrection  = 0, // not available for FreeType
+      .descenderHeight  = static_cast<uint8_t>(2),
+      .spaceSize        = 5,
+      .glyphCount       = static_cast<uint16_t>(glyphCount),
+      .ligKernStepCount = 0, // will be set at save time
+      .pixelsPoolSize   = 0, // will be set at save time
+  }));
+  faces_.push_back(std::move(face));
+
+  return true;
 }
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <fstream>
 #include <iostream>
 
 #include "IBMFFontMod.hpp"
@@ -9,13 +8,24 @@ class IBMFHexImport : public IBMFFontMod {
 public:
   IBMFHexImport() : IBMFFontMod() {}
 
+  // A glyph as found in a .hex file: 16 rows of 1 byte (8 pixels wide glyph) or
+  // 2 bytes (16 pixels wide glyph).
+  struct HexGlyph {
+    char32_t codePoint;
+    uint8_t  byteWidth;
+    uint8_t  bytes[32];
+  };
+  typedef std::vector<HexGlyph> HexGlyphs;
+
   auto charSelected(char32_t ch, SelectedBlockIndexesPtr &selectedBlockIndexes,
                     uint32_t firstBytes) const -> bool;
-  auto prepareCodePlanes(std::fstream &in, CharSelectionsPtr &charSelections) -> int;
-  auto readCodePoint(std::fstream &in, char32_t &codePoint, uint32_t &firstBytes) -> bool;
-  auto readOneGlyph(std::fstream &in, char32_t &codePoint, BitmapPtr bitmap, int8_t &vOffset)
-      -> GlyphCode;
+  auto parseHex(const char *data, const char *end, SelectedBlockIndexesPtr &selectedBlockIndexes,
+                HexGlyphs &hexGlyphs) const -> void;
+  auto prepareCodePlanes(const HexGlyphs &hexGlyphs) -> int;
+  auto cropGlyph(const HexGlyph &hexGlyph, Bitmap &bitmap, int8_t &vOffset) const -> bool;
   auto loadHex(FontParametersPtr fontParameters) -> bool;
+
+  static constexpr int CROPPING_CHUNK_SIZE = 512;
 };
 
 typedef std::shared_ptr<IBMFHexImport> IBMFHexImportPtr;
@@ -1,5 +1,10 @@
 #include "IBMFTTFImport.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #include <QMessageBox>
 
 auto IBMFTTFImport::prepareCodePlanes(FT_Face &face, CharSelections &charSelections) -> int {
@@ -74,6 +79,7 @@ auto IBMFTTFImport::prepareCodePlanes(FT_Face &face, CharSelections &charSelecti
       planes_[idx].codePointBundlesIdx = codePointBundles_.size();
       planes_[idx].firstGlyphCode      = glyphCode;
     }
+    buildCodePointIndex();
   }
 
   return glyphCode;
@@ -101,9 +107,10 @@ auto IBMFTTFImport::charSelected(char32_t ch, SelectedBlockIndexesPtr &selectedB
 
 #define LITTLE_ENDIEN_16(val) val = (val << 8) | (val >> 8);
 
+// Retrieves the first format 0 kern sub-table of the font. The pairs are grouped by their
+// first char index, such that the kernings of a glyph are found without scanning the table.
 auto IBMFTTFImport::retrieveKernPairsTable(FT_Face ftFace) -> void {
-  kernPairs       = nullptr;
-  kernPairsCount  = 0;
+  kernPairsIndex.clear();
 
   FT_ULong length = sizeof(KernTableHeader);
   FT_Error error =
@@ -122,20 +129,19 @@ auto IBMFTTFImport::retrieveKernPairsTable(FT_Face ftFace) -> void {
           length =
               kernSubTableHeader.length - (sizeof(KernSubTableHeader) + sizeof(KernFormat0Header));
           offset += sizeof(KernSubTableHeader) + sizeof(KernFormat0Header);
-          kernPairs = (KernPairsPtr) new uint8_t[length];
-          error = FT_Load_Sfnt_Table(ftFace, TTAG_kern, offset, (FT_Byte *) (kernPairs), &length);
+          KernPairs kernPairs(length / sizeof(KernPair));
+          length = kernPairs.size() * sizeof(KernPair);
+          error  = FT_Load_Sfnt_Table(ftFace, TTAG_kern, offset, (FT_Byte *) (kernPairs.data()),
+                                      &length);
           if (error == 0) {
-            kernPairsCount = length / sizeof(KernPair);
-            for (int i = 0; i < kernPairsCount; i++) {
-              LITTLE_ENDIEN_16(kernPairs[i].first);
-              LITTLE_ENDIEN_16(kernPairs[i].next);
-              LITTLE_ENDIEN_16(kernPairs[i].value);
+            for (auto &kernPair : kernPairs) {
+              LITTLE_ENDIEN_16(kernPair.first);
+              LITTLE_ENDIEN_16(kernPair.next);
+              LITTLE_ENDIEN_16(kernPair.value);
+              kernPairsIndex[kernPair.first].push_back(kernPair);
             }
-            break;
-          } else {
-            kernPairs = nullptr;
-            break;
           }
+          break;
         } else {
           offset += kernSubTableHeader.length;
         }
@@ -146,13 +152,136 @@ auto IBMFTTFImport::retrieveKernPairsTable(FT_Face ftFace) -> void {
   }
 }
 
-auto IBMFTTFImport::findGlyphCodeFromIndex(int index, FT_Face ftFace, int glyphCount) -> GlyphCode {
+// Maps every FreeType char index used by the new font to its glyph code. When many code points
+// share the same FreeType glyph, the lowest glyph code is kept.
+auto IBMFTTFImport::buildGlyphCodesIndex(FT_Face ftFace, int glyphCount) -> void {
+  glyphCodesIndex.clear();
+  glyphCodesIndex.reserve(glyphCount);
   for (GlyphCode glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
-    char32_t ch2 = getUTF32(glyphCode);
-    FT_UInt  idx = FT_Get_Char_Index(ftFace, ch2);
-    if ((idx != 0) && (idx == index)) return glyphCode;
+    FT_UInt index = FT_Get_Char_Index(ftFace, getUTF32(glyphCode));
+    if (index != 0) glyphCodesIndex.emplace(index, glyphCode);
   }
-  return NO_GLYPH_CODE;
+}
+
+auto IBMFTTFImport::findGlyphCodeFromIndex(FT_UInt index) const -> GlyphCode {
+  auto it = glyphCodesIndex.find(index);
+  return (it != glyphCodesIndex.end()) ? it->second : NO_GLYPH_CODE;
+}
+
+// Renders a glyph with the size currently set for ftFace, and retrieves its ligatures and
+// kernings. The result is put at the glyph code position in the face vectors. On error,
+// false is returned with the message to be shown.
+auto IBMFTTFImport::renderGlyph(FT_Face ftFace, Face &face, GlyphCode glyphCode, bool withKerning,
+                                QString &errorTitle, QString &errorMessage) -> bool {
+
+  char32_t ch    = getUTF32(glyphCode);
+  FT_UInt  index = FT_Get_Char_Index(ftFace, ch);
+  if (index == 0) {
+    errorTitle   = "Internal error!";
+    errorMessage = QString("Can't find utf32 codePoint for glyphCode %1)").arg(glyphCode);
+    return false;
+  }
+
+  FT_Error error = FT_Load_Char(ftFace, ch, FT_LOAD_DEFAULT);
+  if (error != 0) {
+    errorTitle   = "FreeType issue";
+    errorMessage = QString("Unable to load codePoint U+%1").arg(ch, 5, 16, QChar('0'));
+    return false;
+  }
+
+  if (ftFace->glyph->format != FT_GLYPH_FORMAT_BITMAP) {
+    error = FT_Render_Glyph(ftFace->glyph, FT_RENDER_MODE_MONO);
+    if (error != 0) {
+      errorTitle   = "FreeType issue";
+      errorMessage = QString("Unable to render codePoint U+%1").arg(ch, 5, 16, QChar('0'));
+      return false;
+    }
+  }
+
+  // ----- Bitmap -----
+
+  BitmapPtr bitmap = BitmapPtr(new Bitmap());
+  uint8_t  *buffer = ftFace->glyph->bitmap.buffer;
+  bitmap->pixels.reserve(ftFace->glyph->bitmap.width * ftFace->glyph->bitmap.rows);
+  for (int row = 0; row < ftFace->glyph->bitmap.rows; row++) {
+    uint8_t mask = 0x80;
+    for (int col = 0; col < ftFace->glyph->bitmap.width; col++) {
+      uint8_t pixel = ((buffer[col >> 3] & mask) == 0) ? 0 : 0xFF;
+      bitmap->pixels.push_back(pixel);
+      mask >>= 1;
+      if (mask == 0) mask = 0x80;
+    }
+    buffer += ftFace->glyph->bitmap.pitch;
+  }
+  bitmap->dim             = Dim(ftFace->glyph->bitmap.width, ftFace->glyph->bitmap.rows);
+
+  face.bitmaps[glyphCode] = bitmap;
+
+  // ----- Ligature / Kerning -----
+
+  GlyphLigKernPtr glyphLigKern = GlyphLigKernPtr(new GlyphLigKern);
+
+  // Create ligatures for the glyph if available
+  // Ensure that both next and replacement glyph codes are present in the
+  // resulting IBMF font
+  for (auto &ligature : ligatures) {
+    if (ligature.firstChar == ch) {
+      GlyphCode nextGlyphCode        = toGlyphCode(ligature.nextChar);
+      GlyphCode replacementGlyphCode = toGlyphCode(ligature.replacement);
+      if ((nextGlyphCode != NO_GLYPH_CODE) && (replacementGlyphCode != NO_GLYPH_CODE)) {
+        glyphLigKern->ligSteps.push_back(GlyphLigStep{
+            .nextGlyphCode = nextGlyphCode, .replacementGlyphCode = replacementGlyphCode});
+      }
+    }
+  }
+
+  if (withKerning) {
+
+    // Retrieve kerning information for each pair defined in the font, need
+    // first to find if the second char is present in this IBMF Font. if so,
+    // create an entry for it
+
+    auto kernPairs = kernPairsIndex.find(index);
+    if (kernPairs != kernPairsIndex.end()) {
+      for (auto &kernPair : kernPairs->second) {
+        GlyphCode glyphCode2 = findGlyphCodeFromIndex(kernPair.next);
+        if (glyphCode2 != NO_GLYPH_CODE) {
+
+          FT_Vector akerning;
+          FT_Get_Kerning(ftFace, index, kernPair.next, FT_KERNING_DEFAULT, &akerning);
+
+          auto kern = static_cast<FIX16>(akerning.x);
+
+          if (kern != 0) {
+            glyphLigKern->kernSteps.push_back(
+                GlyphKernStep{.nextGlyphCode = glyphCode2, .kern = kern});
+          }
+        }
+      }
+    }
+  }
+
+  face.glyphsLigKern[glyphCode] = glyphLigKern;
+
+  // ----- Glyph Info -----
+
+  face.glyphs[glyphCode] = GlyphInfo{
+      .bitmapWidth      = static_cast<uint8_t>(ftFace->glyph->bitmap.width),
+      .bitmapHeight     = static_cast<uint8_t>(ftFace->glyph->bitmap.rows),
+      .horizontalOffset = static_cast<int8_t>(-ftFace->glyph->bitmap_left),
+      .verticalOffset   = static_cast<int8_t>(ftFace->glyph->bitmap_top),
+      .packetLength =
+          static_cast<uint16_t>(ftFace->glyph->bitmap.width * ftFace->glyph->bitmap.rows),
+      .advance         = static_cast<FIX16>(ftFace->glyph->advance.x),
+      .rleMetrics      = RLEMetrics{.dynF               = 0,
+                                    .firstIsBlack       = false,
+                                    .beforeAddedOptKern = 0,
+                                    .afterAddedOptKern  = 0},
+      .ligKernPgmIndex = 0,        // completed at save time
+      .mainCode        = glyphCode // maybe changed below when searching for composites
+  };
+
+  return true;
 }
 
 auto IBMFTTFImport::loadTTF(FreeType &ft, FontParametersPtr fontParameters) -> bool {
@@ -197,194 +326,163 @@ auto IBMFTTFImport::loadTTF(FreeType &ft, FontParametersPtr fontParameters) -> b
 
       uint16_t glyphCount = prepareCodePlanes(ftFace, *sel);
 
+      buildGlyphCodesIndex(ftFace, glyphCount);
+
       // This is a test that could be removed in the future
-      for (GlyphCode i = 0; i < glyphCount; i++) {
-        if ((i != toGlyphCode(getUTF32(i)))) {
-          QMessageBox::critical(nullptr, "Internal Error!!",
-                                QString("Problem with getUTF32() and toGlyphCode() that are not "
-                                        "orthogonal for glyphCode %1")
-                                    .arg(i));
-        }
+      GlyphCode glyphCode;
+      if (!checkCodePointIndex(glyphCode)) {
+        QMessageBox::critical(nullptr, "Internal Error!!",
+                              QString("Problem with getUTF32() and toGlyphCode() that are not "
+                                      "orthogonal for glyphCode %1")
+                                  .arg(glyphCode));
       }
 
       for (int faceIdx = 0; faceIdx < faceCount; faceIdx++) {
-        FT_Error error =
-            FT_Set_Char_Size(ftFace,                   // handle to face object
-                             0,                        // char_width in 1/64th of points
-                             pointSizes[faceIdx] * 64, // char_height in 1/64th of points
-                             fontParameters->dpi,      // horizontal device resolution
-                             fontParameters->dpi);
-        if (error != 0) {
-          QMessageBox::critical(nullptr, "FreeType issue", "Unable to set face sizes");
-          return false;
-        }
-
         FacePtr face = FacePtr(new Face);
+        face->glyphs.resize(glyphCount);
+        face->bitmaps.resize(glyphCount);
+        face->glyphsLigKern.resize(glyphCount);
+        faces_.push_back(std::move(face));
+      }
 
-        // ----- For each glyphCode part of the new font -----
+      // ----- Render the glyphs of all faces -----
+
+      // The glyphs are rendered by chunks of a face, in parallel. As a FreeType face cannot be
+      // shared between threads, each worker opens its own. The chunks of the biggest point
+      // sizes, the longest to render, are done first.
+
+      struct Chunk {
+        int       faceIdx;
+        GlyphCode first, last;
+      };
+      std::vector<Chunk> chunks;
+      for (int faceIdx = faceCount - 1; faceIdx >= 0; faceIdx--) {
+        for (int first = 0; first < glyphCount; first += RENDERING_CHUNK_SIZE) {
+          chunks.push_back(Chunk{
+              .faceIdx = faceIdx,
+              .first   = static_cast<GlyphCode>(first),
+              .last    = static_cast<GlyphCode>(std::min(first + RENDERING_CHUNK_SIZE,
+                                                         static_cast<int>(glyphCount)))});
+        }
+      }
 
-        for (GlyphCode glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
+      std::atomic<int>  nextChunk = 0;
+      std::atomic<bool> failed    = false;
+      std::mutex        errorMutex;
+      QString           errorTitle, errorMessage;
+
+      auto setError = [&](const QString &title, const QString &message) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!failed) {
+          errorTitle   = title;
+          errorMessage = message;
+          failed       = true;
+        }
+      };
 
-          char32_t ch    = getUTF32(glyphCode);
-          FT_UInt  index = FT_Get_Char_Index(ftFace, ch);
-          if (index != 0) {
-            error = FT_Load_Char(ftFace, ch, FT_LOAD_DEFAULT);
+      auto worker = [&]() {
+        FT_Face workerFace = ft.openWorkerFace(filename);
+        if (workerFace == nullptr) {
+          setError("Unable to open font", QString("Not able to open font %1").arg(filename));
+          return;
+        }
+        int currentFaceIdx = -1;
+        int chunkIdx;
+        while (!failed && ((chunkIdx = nextChunk++) < static_cast<int>(chunks.size()))) {
+          Chunk &chunk = chunks[chunkIdx];
+          if (chunk.faceIdx != currentFaceIdx) {
+            FT_Error error = FT_Set_Char_Size(workerFace, 0, pointSizes[chunk.faceIdx] * 64,
+                                              fontParameters->dpi, fontParameters->dpi);
             if (error != 0) {
-              QMessageBox::critical(
-                  nullptr, "FreeType issue",
-                  QString("Unable to load codePoint U+%1").arg(ch, 5, 16, QChar('0')));
-              return false;
+              setError("FreeType issue", "Unable to set face sizes");
+              break;
             }
-
-            if (ftFace->glyph->format != FT_GLYPH_FORMAT_BITMAP) {
-              error = FT_Render_Glyph(ftFace->glyph, FT_RENDER_MODE_MONO);
-              if (error != 0) {
-                QMessageBox::critical(
-                    nullptr, "FreeType issue",
-                    QString("Unable to render codePoint U+%1").arg(ch, 5, 16, QChar('0')));
-                return false;
-              }
+            currentFaceIdx = chunk.faceIdx;
+          }
+          QString title, message;
+          for (GlyphCode glyphCode = chunk.first; glyphCode < chunk.last; glyphCode++) {
+            if (!renderGlyph(workerFace, *faces_[chunk.faceIdx], glyphCode,
+                             fontParameters->withKerning, title, message)) {
+              setError(title, message);
+              break;
             }
+          }
+        }
+        ft.closeFace(workerFace);
+      };
 
-            // ----- Bitmap -----
-
-            BitmapPtr bitmap = BitmapPtr(new Bitmap());
-            uint8_t  *buffer = ftFace->glyph->bitmap.buffer;
-            for (int row = 0; row < ftFace->glyph->bitmap.rows; row++) {
-              uint8_t mask = 0x80;
-              for (int col = 0; col < ftFace->glyph->bitmap.width; col++) {
-                uint8_t pixel = ((buffer[col >> 3] & mask) == 0) ? 0 : 0xFF;
-                bitmap->pixels.push_back(pixel);
-                mask >>= 1;
-                if (mask == 0) mask = 0x80;
-              }
-              buffer += ftFace->glyph->bitmap.pitch;
-            }
-            bitmap->dim = Dim(ftFace->glyph->bitmap.width, ftFace->glyph->bitmap.rows);
-
-            face->bitmaps.push_back(bitmap);
-
-            // ----- Ligature / Kerning -----
-
-            GlyphLigKernPtr glyphLigKern = GlyphLigKernPtr(new GlyphLigKern);
-
-            // Create ligatures for the glyph if available
-            // Ensure that both next and replacement glyph codes are present in the
-            // resulting IBMF font
-            char32_t firstChar = getUTF32(glyphCode);
-            for (auto &ligature : ligatures) {
-              if (ligature.firstChar == firstChar) {
-                GlyphCode nextGlyphCode        = toGlyphCode(ligature.nextChar);
-                GlyphCode replacementGlyphCode = toGlyphCode(ligature.replacement);
-                if ((nextGlyphCode != NO_GLYPH_CODE) && (replacementGlyphCode != NO_GLYPH_CODE)) {
-                  glyphLigKern->ligSteps.push_back(
-                      GlyphLigStep{.nextGlyphCode        = nextGlyphCode,
-                                   .replacementGlyphCode = replacementGlyphCode});
-                }
-              }
-            }
+      int threadCount =
+          std::clamp<int>(std::thread::hardware_concurrency(), 1, std::max<int>(chunks.size(), 1));
 
-            if (fontParameters->withKerning) {
+      std::vector<std::thread> threads;
+      for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for (auto &thread : threads) {
+        thread.join();
+      }
 
-              // Retrieve kerning information for each pair defined in the font, need
-              // first to find if the second char is present in this IBMF Font. if so,
-              // create an entry for it
+      if (failed) {
+        QMessageBox::critical(nullptr, errorTitle, errorMessage);
+        ft.closeFace(ftFace);
+        return false;
+      }
 
-              for (int i = 0; i < kernPairsCount; i++) {
-                if (kernPairs[i].first == index) {
-                  GlyphCode glyphCode2 =
-                      findGlyphCodeFromIndex(kernPairs[i].next, ftFace, glyphCount);
-                  if (glyphCode2 != NO_GLYPH_CODE) {
+      // ----- Check for composite information -----
 
-                    FT_Vector akerning;
-                    FT_Get_Kerning(ftFace, FT_Get_Char_Index(ftFace, getUTF32(glyphCode)),
-                                   FT_Get_Char_Index(ftFace, getUTF32(glyphCode2)),
-                                   FT_KERNING_DEFAULT, &akerning);
+      // If the main composite element is having a kerning table associated with it, it will
+      // be duplicated to the composed codePoint. The composites don't depend on the point
+      // size (the glyphs are not scaled with FT_LOAD_NO_RECURSE): they are retrieved once for
+      // all faces.
 
-                    auto kern = static_cast<FIX16>(akerning.x);
+      std::vector<std::pair<GlyphCode, GlyphCode>> composites; // glyph code, main code
 
-                    if (kern != 0) {
-                      glyphLigKern->kernSteps.push_back(
-                          GlyphKernStep{.nextGlyphCode = glyphCode2, .kern = kern});
-                    }
-                  }
-                }
-              }
-            }
+      for (GlyphCode glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
 
-            face->glyphsLigKern.push_back(glyphLigKern);
-
-            // ----- Glyph Info -----
-
-            GlyphInfoPtr glyphInfo = GlyphInfoPtr(new GlyphInfo(GlyphInfo{
-                .bitmapWidth      = static_cast<uint8_t>(ftFace->glyph->bitmap.width),
-                .bitmapHeight     = static_cast<uint8_t>(ftFace->glyph->bitmap.rows),
-                .horizontalOffset = static_cast<int8_t>(-ftFace->glyph->bitmap_left),
-                .verticalOffset   = static_cast<int8_t>(ftFace->glyph->bitmap_top),
-                .packetLength =
-                    static_cast<uint16_t>(ftFace->glyph->bitmap.width * ftFace->glyph->bitmap.rows),
-                .advance         = static_cast<FIX16>(ftFace->glyph->advance.x),
-                .rleMetrics      = RLEMetrics{.dynF               = 0,
-                                              .firstIsBlack       = false,
-                                              .beforeAddedOptKern = 0,
-                                              .afterAddedOptKern  = 0},
-                .ligKernPgmIndex = 0, // completed at save time
-                .mainCode        = glyphCode  // maybe changed below when searching for composites
-            }));
-
-            face->glyphs.push_back(std::move(glyphInfo));
-          } else {
-            QMessageBox::critical(
-                nullptr, "Internal error!",
-                QString("Can't find utf32 codePoint for glyphCode %1)").arg(glyphCode));
-            return false;
+        char32_t ch = getUTF32(glyphCode);
+        (void) FT_Load_Char(ftFace, ch, FT_LOAD_NO_RECURSE);
+
+        if (ftFace->glyph->format == FT_GLYPH_FORMAT_COMPOSITE) {
+          for (int i = 0; i < ftFace->glyph->num_subglyphs; i++) {
+            FT_Int    p_index;
+            FT_UInt   p_flags;
+            FT_Int    p_arg1;
+            FT_Int    p_arg2;
+            FT_Matrix p_transform;
+            FT_Get_SubGlyph_Info(ftFace->glyph, i, &p_index, &p_flags, &p_arg1, &p_arg2,
+                                 &p_transform);
+            if ((p_flags & 2) && (p_arg1 == 0) && (p_arg2 == 0)) {
+              // We have a main component
+              GlyphCode code = findGlyphCodeFromIndex(p_index);
+
+              if (code != NO_GLYPH_CODE) { composites.push_back({glyphCode, code}); }
+            }
           }
         }
+      }
 
-        // ----- Check for composite information -----
-
-        // If the main composite element is having a kerning table associated with it, it will
-        // be duplicated to the composed codePoint.
-
-        for (GlyphCode glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
-
-          char32_t ch = getUTF32(glyphCode);
-          // FT_UInt  index = FT_Get_Char_Index(ftFace, ch);
-          (void) FT_Load_Char(ftFace, ch, FT_LOAD_NO_RECURSE);
-
-          if (ftFace->glyph->format == FT_GLYPH_FORMAT_COMPOSITE) {
-            //            std::cout << "Glyph composite of index: " << index << ", glyphCode " <<
-            //            glyphCode
-            //                      << std::endl;
-            for (int i = 0; i < ftFace->glyph->num_subglyphs; i++) {
-              FT_Int    p_index;
-              FT_UInt   p_flags;
-              FT_Int    p_arg1;
-              FT_Int    p_arg2;
-              FT_Matrix p_transform;
-              FT_Get_SubGlyph_Info(ftFace->glyph, i, &p_index, &p_flags, &p_arg1, &p_arg2,
-                                   &p_transform);
-              if ((p_flags & 2) && (p_arg1 == 0) && (p_arg2 == 0)) {
-                // We have a main component
-                GlyphCode code = findGlyphCodeFromIndex(p_index, ftFace, glyphCount);
-
-                if (code != NO_GLYPH_CODE) {
-                  face->glyphs[glyphCode]->mainCode = code;
-                  // std::cout << "Composite main code: " << code << " for glyphCode " << glyphCode
-                  //           << "(U+" << std::hex << std::setfill('0') << std::setw(5) << ch
-                  //           << std::dec << ")" << std::endl;
-                  if (face->glyphsLigKern[glyphCode]->kernSteps.size() == 0) {
-                    std::copy(face->glyphsLigKern[code]->kernSteps.begin(),
-                              face->glyphsLigKern[code]->kernSteps.end(),
-                              std::back_inserter(face->glyphsLigKern[glyphCode]->kernSteps));
-                    // if (face->glyphsLigKern[glyphCode]->kernSteps.size() != 0) {
-                    //  std::cout << "Got a main composite with augmented kern vector: "
-                    //            << glyphCode << std::endl;
-                    // }
-                  }
-                }
-              }
-            }
+      for (int faceIdx = 0; faceIdx < faceCount; faceIdx++) {
+        FT_Error error =
+            FT_Set_Char_Size(ftFace,                   // handle to face object
+                             0,                        // char_width in 1/64th of points
+                             pointSizes[faceIdx] * 64, // char_height in 1/64th of points
+                             fontParameters->dpi,      // horizontal device resolution
+                             fontParameters->dpi);
+        if (error != 0) {
+          QMessageBox::critical(nullptr, "FreeType issue", "Unable to set face sizes");
+          ft.closeFace(ftFace);
+          return false;
+        }
+
+        FacePtr &face = faces_[faceIdx];
+
+        for (auto &[glyphCode, code] : composites) {
+          face->glyphs[glyphCode].mainCode = code;
+          if (face->glyphsLigKern[glyphCode]->kernSteps.size() == 0) {
+            std::copy(face->glyphsLigKern[code]->kernSteps.begin(),
+                      face->glyphsLigKern[code]->kernSteps.end(),
+                      std::back_inserter(face->glyphsLigKern[glyphCode]->kernSteps));
           }
         }
 
@@ -438,8 +536,8 @@ auto IBMFTTFImport::loadTTF(FreeType &ft, FontParametersPtr fontParameters) -> b
             .ligKernStepCount = 0, // will be set at save time
             .pixelsPoolSize   = 0, // will be set at save time
         }));
-        faces_.push_back(std::move(face));
       }
+      ft.closeFace(ftFace);
     } else {
       return false;
     }
@@ -44,16 +44,27 @@ private:
     uint16_t next;  // Next char Index
     int16_t  value; // In Font Units
   };
-  typedef KernPair *KernPairsPtr;
-  KernPairsPtr      kernPairs;
-  int               kernPairsCount;
 
 #pragma pack(pop)
 
+  // Kern pairs of the font, grouped by their first char index, in the kern table order
+  typedef std::vector<KernPair>                  KernPairs;
+  typedef std::unordered_map<FT_UInt, KernPairs> KernPairsIndex;
+  KernPairsIndex                                 kernPairsIndex;
+
+  // FreeType char index to the first glyph code using it in the new font
+  typedef std::unordered_map<FT_UInt, GlyphCode> GlyphCodesIndex;
+  GlyphCodesIndex                                glyphCodesIndex;
+
   auto charSelected(char32_t ch, SelectedBlockIndexesPtr &selectedBlockIndexes) const -> bool;
   auto prepareCodePlanes(FT_Face &face, CharSelections &charSelections) -> int;
   auto retrieveKernPairsTable(FT_Face ftFace) -> void;
-  auto findGlyphCodeFromIndex(int index, FT_Face ftFace, int glyphCount) -> GlyphCode;
+  auto buildGlyphCodesIndex(FT_Face ftFace, int glyphCount) -> void;
+  auto findGlyphCodeFromIndex(FT_UInt index) const -> GlyphCode;
+  auto renderGlyph(FT_Face ftFace, Face &face, GlyphCode glyphCode, bool withKerning,
+                   QString &errorTitle, QString &errorMessage) -> bool;
+
+  static constexpr int RENDERING_CHUNK_SIZE = 32;
 
 public:
   IBMFTTFImport() : IBMFFontMod() {}
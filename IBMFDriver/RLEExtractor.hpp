@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 #include <iostream>
@@ -8,6 +9,43 @@
 
 using namespace IBMFDefs;
 
+// Expansion of a non-compressed bitmap byte into 8 EIGHT_BITS pixels, msb first
+struct RLEPixelsLUT {
+  uint8_t pixels[256][8];
+  constexpr RLEPixelsLUT() : pixels() {
+    for (int data = 0; data < 256; data++) {
+      for (int bit = 0; bit < 8; bit++) {
+        pixels[data][bit] = (data & (0x80U >> bit)) ? 0xFF : 0;
+      }
+    }
+  }
+};
+
+// Decoding, for each dynF, of a packed number starting on the high nybble of a byte: its
+// value and its size in nybbles (1 or 2). A size of 0 means that the number is a large one
+// or a repeat count, to be decoded nybble by nybble.
+struct RLEPackedNumberLUT {
+  struct Entry {
+    uint8_t value = 0;
+    uint8_t size  = 0;
+  };
+  Entry entries[16][256];
+  constexpr RLEPackedNumberLUT() : entries() {
+    for (int dynF = 0; dynF < 14; dynF++) {
+      for (int data = 0; data < 256; data++) {
+        int i = data >> 4;
+        if ((i != 0) && (i <= dynF)) {
+          entries[dynF][data].value = i;
+          entries[dynF][data].size  = 1;
+        } else if ((i != 0) && (i < 14)) {
+          entries[dynF][data].value = ((i - dynF - 1) << 4) + (data & 0x0f) + dynF + 1;
+          entries[dynF][data].size  = 2;
+        }
+      }
+    }
+  }
+};
+
 class RLEExtractor {
 private:
   uint32_t repeatCount;
@@ -17,6 +55,9 @@ private:
   const uint8_t PK_REPEAT_COUNT = 14;
   const uint8_t PK_REPEAT_ONCE  = 15;
 
+  static constexpr RLEPixelsLUT       pixelsLUT{};
+  static constexpr RLEPackedNumberLUT packedNumberLUT{};
+
   bool getnext8(uint8_t &val) {
     if (memoryPtr >= memoryEnd) return false;
     val = *memoryPtr++;
@@ -68,7 +109,45 @@ private:
   //   end;
   // end;
 
-  bool getPackedNumber(uint32_t &val, const RLEMetrics &rleMetrics) {
+  // Numbers of one or two nybbles, the vast majority, are decoded a byte at a time through
+  // packedNumberLUT. The others are left to getLongPackedNumber().
+  inline bool getPackedNumber(uint32_t &val, const RLEMetrics &rleMetrics) {
+    uint32_t i;
+    uint8_t  dynF = rleMetrics.dynF;
+
+    if (nybbleFlipper == 0xf0U) {
+      if (memoryPtr < memoryEnd) {
+        auto entry = packedNumberLUT.entries[dynF][*memoryPtr];
+        if (entry.size == 2) {
+          memoryPtr++;
+          val = entry.value;
+          return true;
+        }
+        if (entry.size == 1) {
+          nybbleByte    = *memoryPtr++;
+          nybbleFlipper = 0x0fU;
+          val           = entry.value;
+          return true;
+        }
+      }
+    } else {
+      i = nybbleByte & 0x0f;
+      if ((i != 0) && (i <= dynF)) {
+        nybbleFlipper = 0xf0U;
+        val           = i;
+        return true;
+      }
+      if ((i > dynF) && (i < PK_REPEAT_COUNT) && (memoryPtr < memoryEnd)) {
+        nybbleByte = *memoryPtr++; // The low nybble of this byte is the next one
+        val        = ((i - dynF - 1) << 4) + (nybbleByte >> 4) + dynF + 1;
+        return true;
+      }
+    }
+
+    return getLongPackedNumber(val, rleMetrics);
+  }
+
+  bool getLongPackedNumber(uint32_t &val, const RLEMetrics &rleMetrics) {
     uint8_t  nyb;
     uint32_t i, j;
 
@@ -133,7 +212,7 @@ public:
   bool retrieveBitmap(const RLEBitmap &fromBitmap, Bitmap &toBitmap, const Pos atOffset,
                       const RLEMetrics rleMetrics) {
     // point on the glyphs' bitmap definition
-    memoryPtr = (MemoryPtr) fromBitmap.pixels.data();
+    memoryPtr = (MemoryPtr) fromBitmap.pixels;
     memoryEnd = memoryPtr + fromBitmap.length;
     MemoryPtr toRowPtr;
 
@@ -214,22 +293,25 @@ public:
         uint32_t count = 8;
         uint8_t  data;
 
+        // The bits are expanded up to 8 pixels at a time, as the rows are not byte aligned
         for (uint32_t fromRow = 0; fromRow < (fromBitmap.dim.height);
              fromRow++, toRowPtr += toRowSize) {
-          for (uint32_t toCol = atOffset.x; toCol < (fromBitmap.dim.width + atOffset.x); toCol++) {
+          uint32_t toCol  = atOffset.x;
+          uint32_t endCol = fromBitmap.dim.width + atOffset.x;
+          while (toCol < endCol) {
             if (count >= 8) {
               if (!getnext8(data)) {
                 std::cerr << "Not enough bitmap data!" << std::endl;
                 return false;
               }
-              // std::cout << std::hex << +data << ' ';
               count = 0;
             }
-            toRowPtr[toCol] = (data & (0x80U >> count)) ? 0xFF : 0;
-            count++;
+            uint32_t size = std::min(8 - count, endCol - toCol);
+            memcpy(toRowPtr + toCol, &pixelsLUT.pixels[data][count], size);
+            toCol += size;
+            count += size;
           }
         }
-        // std::cout << std::endl;
       } else {
         uint32_t count = 0;
 
@@ -238,21 +320,20 @@ public:
 
         bool black = !(rleMetrics.firstIsBlack == 1);
 
+        // Runs are written at once, up to the end of the row
         for (uint32_t fromRow = 0; fromRow < (fromBitmap.dim.height);
              fromRow++, toRowPtr += toRowSize) {
-          for (uint32_t toCol = atOffset.x; toCol < (fromBitmap.dim.width + atOffset.x); toCol++) {
+          uint32_t toCol  = atOffset.x;
+          uint32_t endCol = fromBitmap.dim.width + atOffset.x;
+          while (toCol < endCol) {
             if (count == 0) {
               if (!getPackedNumber(count, rleMetrics)) { return false; }
               black = !black;
-              // if (black) {
-              //   std::cout << count << ' ';
-              // }
-              // else {
-              //   std::cout << '(' << count << ')' << ' ';
-              // }
             }
-            if (black) toRowPtr[toCol] = 0xFF;
-            count--;
+            uint32_t size = std::min(count, endCol - toCol);
+            if (black) memset(toRowPtr + toCol, 0xFF, size);
+            toCol += size;
+            count -= size;
           }
 
           // if (repeatCount != 0) std::cout << "Repeat count: " << repeatCount
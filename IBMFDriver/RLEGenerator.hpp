@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
+
 #include "IBMFDefs.hpp"
 using namespace IBMFDefs;
 
@@ -31,12 +36,14 @@ private:
   bool    firstNyb;
   Data    data;
 
-  typedef std::vector<int16_t> RepeatCounts;
-  typedef int                  Chunk;
-  typedef std::vector<Chunk>   Chunks;
+  typedef std::vector<int16_t>  RepeatCounts;
+  typedef int                   Chunk;
+  typedef std::vector<Chunk>    Chunks;
+  typedef std::vector<uint64_t> PackedRows;
 
-  uint8_t dynF;         // = 14 if not compressed
-  bool    firstIsBlack; // if compressed, true if first nibble contains black pixels
+  uint8_t dynF;          // = 14 if not compressed
+  bool    firstIsBlack;  // if compressed, true if first nibble contains black pixels
+  int     defaultLength; // length in bytes of the encoding chosen by the PK heuristic
 
 public:
   RLEGenerator() {
@@ -46,6 +53,7 @@ public:
   }
 
   uint8_t getDynF() { return dynF; }
+  int     getDefaultLength() { return defaultLength; }
   bool    getFirstIsBlack() { return firstIsBlack; }
   DataPtr getData() { return &data; }
 
@@ -204,7 +212,153 @@ public:
     }
   }
 
-  bool encodeBitmap(const BitmapPtr bitmap) {
+  static inline int countTrailingZeros(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return __builtin_ctzll(word);
+#endif
+  }
+
+  // Pack the rows of a bitmap, one bit per pixel, bit n of a word being the n'th of the 64
+  // pixels it covers. Returns false if a pixel is neither 0 nor 0xFF: such a bitmap is left
+  // to computeRepeatCounts() and computeChunks(), as they don't only look at black vs white.
+  bool packRows(const BitmapPtr bitmap, PackedRows &rows, int wordsPerRow) {
+    const uint8_t *pixel = bitmap->pixels.data();
+
+    rows.assign(bitmap->dim.height * wordsPerRow, 0);
+    for (int row = 0; row < bitmap->dim.height; row++) {
+      uint64_t *words = &rows[row * wordsPerRow];
+      for (int col = 0; col < bitmap->dim.width; col++, pixel++) {
+        if (*pixel == 0xFF) {
+          words[col >> 6] |= uint64_t(1) << (col & 63);
+        } else if (*pixel != 0) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Same as computeRepeatCounts(), on packed rows
+  void computePackedRepeatCounts(const BitmapPtr bitmap, const PackedRows &rows,
+                                 int wordsPerRow, RepeatCounts &repeatCounts) {
+    int      width    = bitmap->dim.width;
+    uint64_t lastMask = ((width & 63) == 0) ? ~uint64_t(0) : (uint64_t(1) << (width & 63)) - 1;
+
+    auto isUniform = [&](const uint64_t *words) {
+      uint64_t fill = (words[0] & 1) ? ~uint64_t(0) : 0;
+      for (int i = 0; i < wordsPerRow - 1; i++) {
+        if (words[i] != fill) return false;
+      }
+      return words[wordsPerRow - 1] == (fill & lastMask);
+    };
+
+    repeatCounts.assign(bitmap->dim.height, 0);
+
+    int row     = 0;
+    int current = 1;
+    while (current < bitmap->dim.height) {
+      const uint64_t *words = &rows[row * wordsPerRow];
+      if (isUniform(words)) {
+        row++;
+        current++;
+      } else if (memcmp(words, &rows[current * wordsPerRow], wordsPerRow * sizeof(uint64_t)) ==
+                 0) {
+        repeatCounts[row]++;
+        repeatCounts[current++] = -1;
+      } else {
+        row = current;
+        current++;
+      }
+    }
+  }
+
+  // Same as computeChunks(), on packed rows. The runs are found a word at a time.
+  void computePackedChunks(Chunks &chunks, const BitmapPtr bitmap, const PackedRows &rows,
+                           int wordsPerRow, const RepeatCounts &repeatCounts) {
+    int  width = bitmap->dim.width;
+    bool black = rows[0] & 1;
+
+    // Position of the first pixel at or after col of the row whose color is not black
+    auto nextChange = [&](const uint64_t *words, int col) {
+      uint64_t flip = black ? ~uint64_t(0) : 0;
+      int      idx  = col >> 6;
+      uint64_t word = (words[idx] ^ flip) & (~uint64_t(0) << (col & 63));
+      while (word == 0) {
+        if (++idx == wordsPerRow) return width;
+        word = words[idx] ^ flip;
+      }
+      return std::min((idx << 6) + countTrailingZeros(word), width);
+    };
+
+    chunks.clear();
+    chunks.reserve(50);
+    if (black) chunks.push_back(SET_AS_FIRST_BLACK);
+
+    Chunk chunk = 0;
+    for (int row = 0; row < bitmap->dim.height; row++) {
+      if (repeatCounts[row] == -1) continue;
+      const uint64_t *words       = &rows[row * wordsPerRow];
+      bool            show_repeat = repeatCounts[row] > 0;
+      int             col         = 0;
+      while (true) {
+        int change = nextChange(words, col);
+        chunk += change - col;
+        if (change == width) break;
+        chunks.push_back(chunk);
+        if (show_repeat) {
+          show_repeat = false;
+          chunks.push_back(SET_AS_REPEAT_COUNT(repeatCounts[row]));
+        }
+        black = !black;
+        chunk = 0;
+        col   = change;
+      }
+    }
+    chunks.push_back(chunk);
+  }
+
+  // Exact length in nybbles of the RLE encoding of chunks for a dynF value
+  int rleLength(const Chunks &chunks, int dynF) {
+    const int max_2  = 208 - 15 * dynF;
+    int       length = 0;
+    bool      first  = true;
+    for (auto chunk : chunks) {
+      if (first) {
+        first = false;
+        if (firstIsBlack(chunk)) continue;
+      }
+      int count = chunk;
+      if (REPEAT_COUNT_IS_ONE(count)) {
+        length += 1;
+        continue;
+      }
+      if (IS_A_REPEAT_COUNT(count)) {
+        length += 1;
+        count = REPEAT_COUNT(count);
+      }
+      if (count <= dynF) {
+        length += 1;
+      } else if (count <= max_2) {
+        length += 2;
+      } else {
+        count  = count - max_2 + 15;
+        length += 1;
+        for (int k = 16; k <= count; k <<= 4) {
+          length += 2;
+        }
+      }
+    }
+    return length;
+  }
+
+  // With smallest, the exact length of every encoding is computed: dynF 0 to 13, with and
+  // without repeat counts, and the raw bitmap. The shortest one is retained, the choice of
+  // the PK heuristic winning ties.
+  bool encodeBitmap(const BitmapPtr bitmap, bool smallest = false) {
 
     if ((bitmap->dim.height * bitmap->dim.width) == 0) return false;
 
@@ -218,8 +372,17 @@ public:
     RepeatCounts repeatCounts;
     Chunks       chunks;
 
-    computeRepeatCounts(bitmap, repeatCounts);
-    computeChunks(chunks, bitmap, repeatCounts);
+    // Bitmaps are processed packed, one bit per pixel, when possible
+    PackedRows rows;
+    int        wordsPerRow = (bitmap->dim.width + 63) >> 6;
+    bool       packed      = packRows(bitmap, rows, wordsPerRow);
+    if (packed) {
+      computePackedRepeatCounts(bitmap, rows, wordsPerRow, repeatCounts);
+      computePackedChunks(chunks, bitmap, rows, wordsPerRow, repeatCounts);
+    } else {
+      computeRepeatCounts(bitmap, repeatCounts);
+      computeChunks(chunks, bitmap, repeatCounts);
+    }
 
 #if DEBUG
     showRepeatCounts(repeatCounts);
@@ -285,6 +448,33 @@ public:
       dynF     = 14;
     }
 
+    if (smallest) {
+      if (dynF != 14) compSize = (rleLength(chunks, dynF) + 1) >> 1;
+      defaultLength = compSize;
+
+      Chunks       noRepeatChunks;
+      RepeatCounts noRepeatCounts(bitmap->dim.height, 0);
+      if (packed) {
+        computePackedChunks(noRepeatChunks, bitmap, rows, wordsPerRow, noRepeatCounts);
+      } else {
+        computeChunks(noRepeatChunks, bitmap, noRepeatCounts);
+      }
+
+      // The raw bitmap is already a candidate: the heuristic never retains longer
+      bool noRepeat = false;
+      for (int i = 0; i <= 13; i++) {
+        for (bool withoutRepeats : {false, true}) {
+          int length = (rleLength(withoutRepeats ? noRepeatChunks : chunks, i) + 1) >> 1;
+          if (length < compSize) {
+            compSize = length;
+            dynF     = i;
+            noRepeat = withoutRepeats;
+          }
+        }
+      }
+      if (noRepeat) chunks.swap(noRepeatChunks);
+    }
+
     data.reserve(compSize);
 
 #if DEBUG
@@ -428,6 +618,8 @@ public:
       if (pBit != 8) putByte(buff);
     }
 
+    if (!smallest) defaultLength = data.size();
+
     return true;
   }
 };
@@ -64,21 +64,20 @@ void KerningRenderer::paintEvent(QPaintEvent *event) {
 }
 
 int KerningRenderer::putGlyph(IBMFDefs::GlyphCode code, IBMFDefs::Pos atPos) {
-  IBMFDefs::BitmapPtr       glyphBitmap;
-  IBMFDefs::GlyphInfoPtr    glyphInfo;
-  IBMFDefs::GlyphLigKernPtr ligKerns;
-  font_->getGlyph(faceIdx_, code, glyphInfo, glyphBitmap, ligKerns);
+  IBMFDefs::BitmapConstPtr       glyphBitmap;
+  IBMFDefs::GlyphInfo            glyphInfo;
+  IBMFDefs::GlyphLigKernConstPtr ligKerns;
 
-  if (glyphInfo != nullptr) {
-    int outRow = atPos.y - glyphInfo->verticalOffset;
+  if (font_->viewGlyph(faceIdx_, code, glyphInfo, glyphBitmap, ligKerns)) {
+    int outRow = atPos.y - glyphInfo.verticalOffset;
     for (int inRow = 0; inRow < glyphBitmap->dim.height; inRow++, outRow++) {
-      int outCol = atPos.x - glyphInfo->horizontalOffset;
+      int outCol = atPos.x - glyphInfo.horizontalOffset;
       for (int inCol = 0; inCol < glyphBitmap->dim.width; inCol++, outCol++) {
         uint8_t pixel = glyphBitmap->pixels[inRow * glyphBitmap->dim.width + inCol];
         if (pixel) glyphsBitmap_.pixels[outRow * glyphsBitmap_.dim.width + outCol] = pixel;
       }
     }
-    return (glyphInfo->advance + 32) >> 6;
+    return (glyphInfo.advance + 32) >> 6;
   } else {
     // std::cout << "Nothing received from font" << std::endl;
     return 0;
@@ -1,10 +1,14 @@
 #include "drawingSpace.h"
 
+#include <algorithm>
 #include <array>
+#include <climits>
 #include <cmath>
 #include <iostream>
 
+#include <QPaintEvent>
 #include <QPainter>
+#include <QResizeEvent>
 
 DrawingSpace::DrawingSpace(IBMFFontModPtr font, int faceIdx, QWidget *parent)
     : QWidget{parent}, font_(font), faceIdx_(faceIdx) {
@@ -14,17 +18,46 @@ DrawingSpace::DrawingSpace(IBMFFontModPtr font, int faceIdx, QWidget *parent)
 void DrawingSpace::setBypassGlyph(IBMFDefs::GlyphCode glyphCode, IBMFDefs::BitmapPtr bitmap,
                                   IBMFDefs::GlyphInfoPtr    glyphInfo,
                                   IBMFDefs::GlyphLigKernPtr glyphLigKern) {
-  if (bitmap.get() != nullptr) {
-    bypassGlyphCode_    = glyphCode;
-    bypassBitmap_       = bitmap;
-    bypassGlyphInfo_    = glyphInfo;
-    bypassGlyphLigKern_ = glyphLigKern;
+  if (bitmap.get() == nullptr) {
+    if (bypassGlyphCode_ != NO_GLYPH_CODE) {
+      bypassGlyphCode_ = NO_GLYPH_CODE;
+      computeSize();
+    }
+    return;
+  }
+
+  // Called on each pixel edit of the glyph: the text is laid out again only when the glyph
+  // positions depend on the change. Otherwise, the new bitmap takes the place of the
+  // previous one in the glyph runs and only its image has to be computed again.
+  bool samePositions = layoutValid_ && !opticalKerning_ && (bypassGlyphCode_ != NO_GLYPH_CODE) &&
+                       (glyphCode == bypassGlyphCode_) && (glyphLigKern == bypassGlyphLigKern_) &&
+                       (bitmap->dim == bypassBitmap_->dim) &&
+                       (glyphInfo->bitmapWidth == bypassGlyphInfo_->bitmapWidth) &&
+                       (glyphInfo->horizontalOffset == bypassGlyphInfo_->horizontalOffset) &&
+                       (glyphInfo->verticalOffset == bypassGlyphInfo_->verticalOffset) &&
+                       (glyphInfo->advance == bypassGlyphInfo_->advance);
+
+  if (samePositions) {
+    for (auto &run : glyphRuns_) {
+      if (run.bitmap == bypassBitmap_) run.bitmap = bitmap;
+    }
+    glyphImages_.erase(bypassBitmap_.get());
+  }
+
+  bypassGlyphCode_    = glyphCode;
+  bypassBitmap_       = bitmap;
+  bypassGlyphInfo_    = glyphInfo;
+  bypassGlyphLigKern_ = glyphLigKern;
+
+  if (samePositions) {
+    update();
   } else {
-    bypassGlyphCode_ = NO_GLYPH_CODE;
+    computeSize();
   }
-  update();
 }
 
+void DrawingSpace::glyphsChanged() { computeSize(); }
+
 typedef int32_t FIX32;
 
 #define FRACT_BITS          10
@@ -40,33 +73,34 @@ typedef int32_t FIX32;
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 
-auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBMFDefs::BitmapPtr b2,
-                                         const IBMFDefs::GlyphInfoPtr i1,
-                                         const IBMFDefs::GlyphInfoPtr i2) const -> FIX16 {
+auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapConstPtr b1,
+                                         const IBMFDefs::BitmapConstPtr b2,
+                                         const IBMFDefs::GlyphInfo &i1,
+                                         const IBMFDefs::GlyphInfo &i2) const -> FIX16 {
   FIX16 result1 = 0;
 
   int normal_distance =
-      i1->horizontalOffset + ((i1->advance + 32) >> 6) - i1->bitmapWidth - i2->horizontalOffset;
+      i1.horizontalOffset + ((i1.advance + 32) >> 6) - i1.bitmapWidth - i2.horizontalOffset;
 
   // std::cout << "Normal distance:" << normal_distance << std::endl;
 
-  int8_t origin = MAX(i1->verticalOffset, i2->verticalOffset);
+  int8_t origin = MAX(i1.verticalOffset, i2.verticalOffset);
 
   // start positions in each dist arrays
-  uint8_t distIdxLeft  = origin - i1->verticalOffset;
-  uint8_t distIdxRight = origin - i2->verticalOffset;
+  uint8_t distIdxLeft  = origin - i1.verticalOffset;
+  uint8_t distIdxRight = origin - i2.verticalOffset;
 
   // idx and length in each bitmaps to compare
-  uint8_t firstIdxLeft  = origin - i2->verticalOffset;
-  uint8_t firstIdxRight = origin - i1->verticalOffset;
-  int8_t  length   = MIN((i1->bitmapHeight - firstIdxLeft), (i2->bitmapHeight - firstIdxRight));
+  uint8_t firstIdxLeft  = origin - i2.verticalOffset;
+  uint8_t firstIdxRight = origin - i1.verticalOffset;
+  int8_t  length   = MIN((i1.bitmapHeight - firstIdxLeft), (i2.bitmapHeight - firstIdxRight));
   uint8_t firstIdx = MAX(firstIdxLeft, firstIdxRight);
 
   FIX32 kerning    = 0;
   // if (length > 0) { // Length <= 0 means that there is no alignment between the characters
   //  hight of significant parts of dist arrays
-  int8_t hight = origin + MAX((i1->bitmapHeight - i1->verticalOffset),
-                              (i2->bitmapHeight - i2->verticalOffset));
+  int8_t hight = origin + MAX((i1.bitmapHeight - i1.verticalOffset),
+                              (i2.bitmapHeight - i2.verticalOffset));
 
   // distance computation for left and right characters
   auto distLeft  = std::shared_ptr<FIX32[]>(new FIX32[hight]);
@@ -80,9 +114,9 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
   // distLeft is receiving the right distance in pixels of the first black pixel on each
   // line of the character
   int idx = 0;
-  for (uint8_t i = distIdxLeft; i < i1->bitmapHeight + distIdxLeft; i++, idx += i1->bitmapWidth) {
+  for (uint8_t i = distIdxLeft; i < i1.bitmapHeight + distIdxLeft; i++, idx += i1.bitmapWidth) {
     distLeft[i] = 0;
-    for (int col = i1->bitmapWidth - 1; col >= 0; col--) {
+    for (int col = i1.bitmapWidth - 1; col >= 0; col--) {
       if (b1->pixels[idx + col]) break;
       distLeft[i] += FIXED_POINT_ONE;
     }
@@ -91,9 +125,9 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
   // distRight is receiving the left distance in pixels of the first black pixel on each
   // line of the character
   idx = 0;
-  for (uint8_t i = distIdxRight; i < i2->bitmapHeight + distIdxRight; i++, idx += i2->bitmapWidth) {
+  for (uint8_t i = distIdxRight; i < i2.bitmapHeight + distIdxRight; i++, idx += i2.bitmapWidth) {
     distRight[i] = 0;
-    for (int col = 0; col < i2->bitmapWidth; col++) {
+    for (int col = 0; col < i2.bitmapWidth; col++) {
       if (b2->pixels[idx + col]) break;
       distRight[i] += FIXED_POINT_ONE;
     }
@@ -102,7 +136,7 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
   // find convex corner locations and adjust distances
 
   // Right Side Convex Hull for the character at left
-  if (i1->bitmapHeight >= 3) { // 1 and 2 line characters don't need adjustment
+  if (i1.bitmapHeight >= 3) { // 1 and 2 line characters don't need adjustment
 
     // Compute the cross product of 3 points. If negative, the angle is convex
     auto crossLeft = [distLeft](int i, int j, int k) -> FIX32 {
@@ -130,9 +164,9 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
     // to get the right portion of the Convex Hull polygon.
     int i = distIdxLeft;
     int j = i + 1;
-    while (j < (i1->bitmapHeight + distIdxLeft)) {
+    while (j < (i1.bitmapHeight + distIdxLeft)) {
       bool found = true;
-      for (int k = j + 1; k < i1->bitmapHeight + distIdxLeft; k++) {
+      for (int k = j + 1; k < i1.bitmapHeight + distIdxLeft; k++) {
         FIX32 val = crossLeft(i, j, k);
         if (val >= 0) {
           found = false;
@@ -151,7 +185,7 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
 
   // Left side Convex Hull for the character at right
 
-  if (i2->bitmapHeight >= 3) { // 1 and 2 line characters don't need adjustment
+  if (i2.bitmapHeight >= 3) { // 1 and 2 line characters don't need adjustment
 
     // Compute the cross product of 3 points. If negative, the angle is convex.
     auto crossRight = [distRight](int i, int j, int k) -> FIX32 {
@@ -179,9 +213,9 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
     // to get the left portion of the Convex Hull polygon.
     int i = distIdxRight;
     int j = i + 1;
-    while (j < (i2->bitmapHeight + distIdxRight)) {
+    while (j < (i2.bitmapHeight + distIdxRight)) {
       bool found = true;
-      for (int k = j + 1; k < i2->bitmapHeight + distIdxRight; k++) {
+      for (int k = j + 1; k < i2.bitmapHeight + distIdxRight; k++) {
         FIX32 val = crossRight(i, j, k);
         if (val >= 0) {
           found = false;
@@ -271,12 +305,12 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
 
   int addedWildcard;
 
-  if (i2->rleMetrics.beforeAddedOptKern == 3) {
+  if (i2.rleMetrics.beforeAddedOptKern == 3) {
     addedWildcard = -1;
   } else {
-    addedWildcard = i2->rleMetrics.beforeAddedOptKern;
+    addedWildcard = i2.rleMetrics.beforeAddedOptKern;
   }
-  addedWildcard += i1->rleMetrics.afterAddedOptKern;
+  addedWildcard += i1.rleMetrics.afterAddedOptKern;
 
   // std::cout << "Minimal distance: " << MAKE_FIXED_FLOAT(kerning) << std::endl;
 
@@ -284,7 +318,7 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
   // between characters), the size of the character and the normal distance that will be used by
   // the writing algorithm
   kerning = (-MIN(kerning - MAKE_INT_FIXED(KERNING_SIZE + addedWildcard),
-                  MAKE_INT_FIXED(i2->bitmapWidth))) -
+                  MAKE_INT_FIXED(i2.bitmapWidth))) -
             MAKE_INT_FIXED(normal_distance);
   // }
 
@@ -296,13 +330,16 @@ auto DrawingSpace::computeOpticalKerning(const IBMFDefs::BitmapPtr b1, const IBM
 }
 
 void DrawingSpace::setFont(IBMFFontModPtr font) {
-  font_    = font;
-  faceIdx_ = 0;
+  font_        = font;
+  faceIdx_     = 0;
+  layoutValid_ = false;
+  glyphImages_.clear();
 }
 
 void DrawingSpace::setFaceIdx(int faceIdx) {
   if ((font_ != nullptr) && (faceIdx < font_->getPreamble().faceCount) && (faceIdx >= 0)) {
     faceIdx_ = faceIdx;
+    glyphImages_.clear();
     computeSize();
   }
 }
@@ -324,12 +361,13 @@ void DrawingSpace::setNormalKerning(bool value) {
 
 void DrawingSpace::setPixelSize(int value) {
   pixelSize_ = value;
+  glyphImages_.clear();
   computeSize();
 }
 
 auto DrawingSpace::computeSize() -> void {
   if ((font_ != nullptr) && (faceIdx_ < font_->getPreamble().faceCount) && (faceIdx_ >= 0)) {
-    drawScreen(nullptr);
+    layout();
     requiredSize_ = QSize(width(), (pos_.y() + font_->getLineHeight(faceIdx_)) * pixelSize_);
     //    adjustSize();
     update();
@@ -343,73 +381,63 @@ QSize DrawingSpace::sizeHint() const {
   return requiredSize_;
 }
 
-void DrawingSpace::printWord(WordPtr &word, QPainter *painter) {
-
-  QRect rect;
+// Position the glyphs of a word, appending them to the glyph runs of the current line
+auto DrawingSpace::layoutWord(WordPtr &word) -> void {
 
   bool firstChar = true;
   for (auto &ch : *word) {
 
     //    std::cout << "Position:" << pos_.x();
-    //    std::cout << " CH kern:" << ch->kern / 64 << " adv:" << ch->glyphInfo->advance / 64
-    //              << " hoff:" << +ch->glyphInfo->horizontalOffset << std::endl;
+    //    std::cout << " CH kern:" << ch.kern / 64 << " adv:" << ch.glyphInfo.advance / 64
+    //              << " hoff:" << +ch.glyphInfo.horizontalOffset << std::endl;
 
-    //    int diff = ((ch->kern + (ch->kern < 0 ? -32 : 32)) / 64);
+    //    int diff = ((ch.kern + (ch.kern < 0 ? -32 : 32)) / 64);
     //    pos_.setX(pos_.x() + diff);
 
-    int voff = ch->glyphInfo->verticalOffset;
+    int voff = ch.glyphInfo.verticalOffset;
 
     // The first character of a word must not use the horizontalOffset.
     // Also, there is a need to remove the effect on the advance param (hoff2),
     // see at the end of the loop.
-    int hoff    = firstChar ? 0 : ch->glyphInfo->horizontalOffset;
-    int hoff2   = firstChar ? -ch->glyphInfo->horizontalOffset : 0;
-
-    int advance = (ch->glyphInfo->advance + 32) >> 6;
-    if (advance == 0) advance = ch->glyphInfo->bitmapWidth + 1;
-
-    if (painter != nullptr) {
-      int idx = 0;
-      if (pixelSize_ == 1) {
-        for (int row = 0; row < ch->bitmap->dim.height; row++) {
-          for (int col = 0; col < ch->bitmap->dim.width; col++, idx++) {
-            if (ch->bitmap->pixels[idx] != 0) {
-              painter->drawPoint(QPoint(10 + (pos_.x() - hoff + col), pos_.y() - voff + row));
-            }
-          }
-        }
-      } else {
-        for (int row = 0; row < ch->bitmap->dim.height; row++) {
-          for (int col = 0; col < ch->bitmap->dim.width; col++, idx++) {
-            if (ch->bitmap->pixels[idx] != 0) {
-              rect = QRect(10 + (pos_.x() - hoff + col) * pixelSize_,
-                           (pos_.y() - voff + row) * pixelSize_, pixelSize_, pixelSize_);
+    int hoff    = firstChar ? 0 : ch.glyphInfo.horizontalOffset;
+    int hoff2   = firstChar ? -ch.glyphInfo.horizontalOffset : 0;
 
-              painter->drawRect(rect);
-            }
-          }
-        }
-      }
-    }
+    int advance = (ch.glyphInfo.advance + 32) >> 6;
+    if (advance == 0) advance = ch.glyphInfo.bitmapWidth + 1;
+
+    glyphRuns_.push_back(GlyphRun{.glyphCode = ch.glyphCode,
+                                  .x         = pos_.x() - hoff,
+                                  .y         = pos_.y() - voff,
+                                  .kern      = ch.kern,
+                                  .bitmap    = ch.bitmap});
 
-    pos_.setX(pos_.x() + advance - hoff2 + ((ch->kern + (ch->kern < 0 ? -32 : 32)) / 64));
+    pos_.setX(pos_.x() + advance - hoff2 + ((ch.kern + (ch.kern < 0 ? -32 : 32)) / 64));
     firstChar = false;
   }
 
   // Adjustment for the last character of a word. This is to get equal spaces between characters.
 
   // auto &ch = word->at(word->size() - 1);
-  // pos_.setX(pos_.x() - (((ch->glyphInfo->advance + 32) >> 6) + ch->glyphInfo->horizontalOffset -
-  //                       ch->bitmap->dim.width));
+  // pos_.setX(pos_.x() - (((ch.glyphInfo.advance + 32) >> 6) + ch.glyphInfo.horizontalOffset -
+  //                       ch.bitmap->dim.width));
 }
 
-auto DrawingSpace::printLine(QPainter *painter) -> void {
+auto DrawingSpace::layoutLine() -> void {
+
+  int firstRun = glyphRuns_.size();
 
   for (auto &w : line_) {
-    printWord(w, painter);
+    layoutWord(w);
     pos_.setX(pos_.x() + font_->getFaceHeader(faceIdx_)->spaceSize);
   }
 
+  LineRange line{.firstRun = firstRun, .top = INT_MAX, .bottom = INT_MIN};
+  for (int idx = firstRun; idx < glyphRuns_.size(); idx++) {
+    line.top    = std::min(line.top, glyphRuns_[idx].y);
+    line.bottom = std::max(line.bottom, glyphRuns_[idx].y + glyphRuns_[idx].bitmap->dim.height);
+  }
+  lines_.push_back(line);
+
   pos_.setY(pos_.y() + font_->getLineHeight(faceIdx_));
   pos_.setX(0);
 
@@ -417,16 +445,17 @@ auto DrawingSpace::printLine(QPainter *painter) -> void {
   linePixelWidth_ = 0;
 }
 
-auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
+auto DrawingSpace::addWordToLine(QString &w) -> void {
 
   auto word = WordPtr(new Word);
 
   auto iter = w.begin();
 
-  IBMFDefs::BitmapPtr       b1, b2;
-  IBMFDefs::GlyphInfoPtr    i1, i2;
-  IBMFDefs::GlyphCode       g1, g2;
-  IBMFDefs::GlyphLigKernPtr k1, k2;
+  // The glyphs are viewed in the font, without copy
+  IBMFDefs::BitmapConstPtr       b1, b2;
+  IBMFDefs::GlyphInfo            i1{}, i2{};
+  IBMFDefs::GlyphCode            g1, g2;
+  IBMFDefs::GlyphLigKernConstPtr k1, k2;
 
   g1                   = font_->translate((*iter++).unicode());
   g2                   = (iter == w.end()) ? NO_GLYPH_CODE : font_->translate((*iter++).unicode());
@@ -438,7 +467,7 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
   int  wordPixelWidth  = 0;
 
   if (linePixelWidth_ > 0) { linePixelWidth_ += spaceSize_; }
-  if ((linePixelWidth_ * pixelSize_ + 20) > this->width()) { printLine(painter); }
+  if ((linePixelWidth_ * pixelSize_ + 20) > this->width()) { layoutLine(); }
 
   while (g1 != NO_GLYPH_CODE) {
     bool g2_loaded = false;
@@ -447,10 +476,10 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
       firstWordChar = false;
       if ((bypassGlyphCode_ != IBMFDefs::NO_GLYPH_CODE) && (g1 == bypassGlyphCode_)) {
         b1 = bypassBitmap_;
-        i1 = bypassGlyphInfo_;
+        i1 = *bypassGlyphInfo_;
         k1 = bypassGlyphLigKern_;
       } else {
-        if (!font_->getGlyph(faceIdx_, g1, i1, b1, k1)) { break; }
+        if (!font_->viewGlyph(faceIdx_, g1, i1, b1, k1)) { break; }
       }
     }
 
@@ -465,20 +494,20 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
 
         if ((bypassGlyphCode_ != IBMFDefs::NO_GLYPH_CODE) && (g1 == bypassGlyphCode_)) {
           b1 = bypassBitmap_;
-          i1 = bypassGlyphInfo_;
+          i1 = *bypassGlyphInfo_;
           k1 = bypassGlyphLigKern_;
         } else {
-          if (!font_->getGlyph(faceIdx_, g1, i1, b1, k1)) { break; }
+          if (!font_->viewGlyph(faceIdx_, g1, i1, b1, k1)) { break; }
         }
       }
 
       if (g2 != NO_GLYPH_CODE) {
         if ((bypassGlyphCode_ != IBMFDefs::NO_GLYPH_CODE) && (g2 == bypassGlyphCode_)) {
           b2 = bypassBitmap_;
-          i2 = bypassGlyphInfo_;
+          i2 = *bypassGlyphInfo_;
           k2 = bypassGlyphLigKern_;
         } else {
-          if (!font_->getGlyph(faceIdx_, g2, i2, b2, k2)) { break; }
+          if (!font_->viewGlyph(faceIdx_, g2, i2, b2, k2)) { break; }
         }
         g2_loaded = true;
 
@@ -495,10 +524,10 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
 
             if ((bypassGlyphCode_ != IBMFDefs::NO_GLYPH_CODE) && (g2 == bypassGlyphCode_)) {
               b2 = bypassBitmap_;
-              i2 = bypassGlyphInfo_;
+              i2 = *bypassGlyphInfo_;
               k2 = bypassGlyphLigKern_;
             } else {
-              if (!font_->getGlyph(faceIdx_, g2, i2, b2, k2)) { break; }
+              if (!font_->viewGlyph(faceIdx_, g2, i2, b2, k2)) { break; }
             }
           }
           if (some_lig) { font_->ligKern(faceIdx_, g1, &g2, &kern, &kernPairPresent); }
@@ -509,10 +538,10 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
     if ((!g2_loaded) && (g2 != NO_GLYPH_CODE)) {
       if ((bypassGlyphCode_ != IBMFDefs::NO_GLYPH_CODE) && (g2 == bypassGlyphCode_)) {
         b2 = bypassBitmap_;
-        i2 = bypassGlyphInfo_;
+        i2 = *bypassGlyphInfo_;
         k2 = bypassGlyphLigKern_;
       } else {
-        if (!font_->getGlyph(faceIdx_, g2, i2, b2, k2)) { break; }
+        if (!font_->viewGlyph(faceIdx_, g2, i2, b2, k2)) { break; }
       }
     }
 
@@ -520,7 +549,7 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
       kern = computeOpticalKerning(b1, b2, i1, i2);
     }
 
-    if (((linePixelWidth_ + wordPixelWidth + ((i1->advance + 32) >> 6)) * pixelSize_ + 20) >
+    if (((linePixelWidth_ + wordPixelWidth + ((i1.advance + 32) >> 6)) * pixelSize_ + 20) >
         this->width()) {
       if ((line_.size() == 0) && (word->size() > 0)) {
         line_.push_back(word);
@@ -529,8 +558,8 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
       }
     }
 
-    word->push_back(OneGlyphPtr(new OneGlyph{.bitmap = b1, .glyphInfo = i1, .kern = kern}));
-    wordPixelWidth += ((i1->advance + 32) >> 6);
+    word->push_back(OneGlyph{.glyphCode = g1, .bitmap = b1, .glyphInfo = i1, .kern = kern});
+    wordPixelWidth += ((i1.advance + 32) >> 6);
 
     g1 = g2;
     i1 = i2;
@@ -541,7 +570,7 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
   }
 
   if (((linePixelWidth_ + wordPixelWidth) * pixelSize_ + 20) > this->width()) {
-    printLine(painter);
+    layoutLine();
   }
   line_.push_back(word);
   linePixelWidth_ += wordPixelWidth;
@@ -549,17 +578,16 @@ auto DrawingSpace::addWordToLine(QString &w, QPainter *painter) -> void {
   w.clear();
 }
 
-void DrawingSpace::drawScreen(QPainter *painter) {
+// Position all glyphs of the text. It is only done when the text, the font, the kerning
+// options, the pixel size or the widget width change, not on each paint event.
+auto DrawingSpace::layout() -> void {
 
-  std::cout << "Window width: " << this->width() << std::endl;
+  glyphRuns_.clear();
+  lines_.clear();
+  layoutValid_ = true;
 
   if ((font_ == nullptr) || textToDraw_.isEmpty()) return;
 
-  if (painter != nullptr) {
-    painter->setPen(QPen(QBrush(QColorConstants::DarkGray), 1));
-    painter->setBrush(QBrush(QColorConstants::DarkGray));
-  }
-
   line_.clear();
   linePixelWidth_ = 0;
   spaceSize_      = font_->getFaceHeader(faceIdx_)->spaceSize;
@@ -569,21 +597,101 @@ void DrawingSpace::drawScreen(QPainter *painter) {
 
   for (auto &ch : textToDraw_) {
     if (ch == ' ') {
-      if (word.length() > 0) { addWordToLine(word, painter); }
+      if (word.length() > 0) { addWordToLine(word); }
     } else if (ch == '\n') {
-      if (word.length() > 0) { addWordToLine(word, painter); }
-      if (line_.size() > 0) { printLine(painter); }
+      if (word.length() > 0) { addWordToLine(word); }
+      if (line_.size() > 0) { layoutLine(); }
     } else {
       word.append(ch);
     }
   }
 
-  if (word.length() > 0) { addWordToLine(word, painter); }
-  if (line_.size() > 0) { printLine(painter); }
+  if (word.length() > 0) { addWordToLine(word); }
+  if (line_.size() > 0) { layoutLine(); }
+
+  // Glyphs may go past their line height: the lines extents are replaced by the lowest
+  // top of the following lines and the highest bottom of the preceding ones. Both are
+  // then in increasing order.
+  for (int idx = lines_.size() - 2; idx >= 0; idx--) {
+    lines_[idx].top = std::min(lines_[idx].top, lines_[idx + 1].top);
+  }
+  for (int idx = 1; idx < lines_.size(); idx++) {
+    lines_[idx].bottom = std::max(lines_[idx].bottom, lines_[idx - 1].bottom);
+  }
+
+  // Images of bitmaps no longer part of the layout nor of the font are released
+  for (auto it = glyphImages_.begin(); it != glyphImages_.end();) {
+    it = (it->second.bitmap.use_count() == 1) ? glyphImages_.erase(it) : std::next(it);
+  }
+}
+
+// Draw the laid out glyphs that intersect the region, in widget coordinates
+void DrawingSpace::drawScreen(QPainter *painter, const QRect &region) {
+
+  if (!layoutValid_) { layout(); }
+
+  // Only the lines that may intersect the region are considered. The pen draws the pixels
+  // one device pixel past their right and bottom edges.
+  int top          = (region.top() - 1) / pixelSize_;
+  int bottom       = region.bottom() / pixelSize_ + 1;
+
+  auto endsAbove   = [top](const LineRange &line) { return line.bottom <= top; };
+  auto startsAbove = [bottom](const LineRange &line) { return line.top < bottom; };
+  auto firstLine   = std::partition_point(lines_.begin(), lines_.end(), endsAbove);
+  auto endLine     = std::partition_point(firstLine, lines_.end(), startsAbove);
+
+  int firstRun     = (firstLine == lines_.end()) ? glyphRuns_.size() : firstLine->firstRun;
+  int endRun       = (endLine == lines_.end()) ? glyphRuns_.size() : endLine->firstRun;
+
+  for (int runIdx = firstRun; runIdx < endRun; runIdx++) {
+    const GlyphRun &run = glyphRuns_[runIdx];
+    if ((run.bitmap->dim.width == 0) || (run.bitmap->dim.height == 0)) continue;
+
+    const QImage &image = glyphImage(run.bitmap);
+    QPoint        pos(10 + run.x * pixelSize_, run.y * pixelSize_);
+    if (region.intersects(QRect(pos.x(), pos.y(), image.width(), image.height()))) {
+      painter->drawImage(pos, image);
+    }
+  }
+}
+
+// The glyph bitmap rasterized at the current pixel size, computed on first use. Each
+// pixel is drawn as it would be with the painter: a pixelSize_ square outlined with a one
+// pixel pen, that goes one device pixel past its right and bottom edges.
+auto DrawingSpace::glyphImage(const IBMFDefs::BitmapConstPtr &bitmap) -> const QImage & {
+  auto it = glyphImages_.find(bitmap.get());
+  if (it != glyphImages_.end()) return it->second.image;
+
+  int    penOverflow = (pixelSize_ == 1) ? 0 : 1;
+  int    squareSize  = pixelSize_ + penOverflow;
+  QImage image(bitmap->dim.width * pixelSize_ + penOverflow,
+               bitmap->dim.height * pixelSize_ + penOverflow, QImage::Format_ARGB32_Premultiplied);
+  image.fill(Qt::transparent);
+
+  QRgb color = QColor(QColorConstants::DarkGray).rgba();
+  int  idx   = 0;
+  for (int row = 0; row < bitmap->dim.height; row++) {
+    for (int col = 0; col < bitmap->dim.width; col++, idx++) {
+      if (bitmap->pixels[idx] != 0) {
+        for (int y = row * pixelSize_; y < row * pixelSize_ + squareSize; y++) {
+          QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+          std::fill(&line[col * pixelSize_], &line[col * pixelSize_ + squareSize], color);
+        }
+      }
+    }
+  }
+
+  return glyphImages_.emplace(bitmap.get(), GlyphImage{.bitmap = bitmap, .image = image})
+      .first->second.image;
 }
 
 void DrawingSpace::paintEvent(QPaintEvent *event) {
   if (font_ == nullptr) return;
   QPainter painter(this);
-  drawScreen(&painter);
+  drawScreen(&painter, event->rect());
+}
+
+void DrawingSpace::resizeEvent(QResizeEvent *event) {
+  // Lines are broken according to the widget width
+  if (event->size().width() != event->oldSize().width()) { computeSize(); }
 }
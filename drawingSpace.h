@@ -1,5 +1,8 @@
 #pragma once
 
+#include <unordered_map>
+
+#include <QImage>
 #include <QPainter>
 #include <QSize>
 #include <QWidget>
@@ -12,7 +15,7 @@ class DrawingSpace : public QWidget {
   Q_OBJECT
 public:
   explicit DrawingSpace(IBMFFontModPtr font = nullptr, int faceIdx = 0, QWidget *parent = nullptr);
-  void drawScreen(QPainter *painter);
+  void drawScreen(QPainter *painter, const QRect &region);
 
   void setText(QString text);
   void setOpticalKerning(bool value);
@@ -22,22 +25,26 @@ public:
   void setFaceIdx(int faceIdx);
   void setBypassGlyph(IBMFDefs::GlyphCode glyphCode, IBMFDefs::BitmapPtr bitmap,
                       IBMFDefs::GlyphInfoPtr glyphInfo, GlyphLigKernPtr glyphLigKern);
+  // To be called when glyphs or face headers of the font have been modified
+  void glyphsChanged();
 
 signals:
 
 protected:
   void  paintEvent(QPaintEvent *event) override;
+  void  resizeEvent(QResizeEvent *event) override;
   QSize sizeHint() const override;
 
 private:
+  // The bitmap is shared with the font (see IBMFFontMod::viewGlyph())
   struct OneGlyph {
-    IBMFDefs::BitmapPtr    bitmap;
-    IBMFDefs::GlyphInfoPtr glyphInfo;
-    FIX16                  kern;
+    IBMFDefs::GlyphCode      glyphCode;
+    IBMFDefs::BitmapConstPtr bitmap;
+    IBMFDefs::GlyphInfo      glyphInfo;
+    FIX16                    kern;
   };
-  typedef std::shared_ptr<OneGlyph> OneGlyphPtr;
 
-  typedef std::vector<OneGlyphPtr> Word;
+  typedef std::vector<OneGlyph> Word;
   typedef std::shared_ptr<Word>    WordPtr;
 
   typedef std::vector<WordPtr> Line;
@@ -47,6 +54,37 @@ private:
   int                   spaceSize_;
   std::vector<OneGlyph> word_;
 
+  // The outcome of the layout: each glyph of the text with the position of its bitmap top
+  // left corner, in font pixels, and the lines they are part of.
+  struct GlyphRun {
+    IBMFDefs::GlyphCode      glyphCode;
+    int                      x;
+    int                      y;
+    FIX16                    kern;
+    IBMFDefs::BitmapConstPtr bitmap;
+  };
+
+  // A line starts at firstRun in glyphRuns_. Its vertical extent in font pixels is
+  // made monotonic over the lines (see layout()), to binary search the lines of a region.
+  struct LineRange {
+    int firstRun;
+    int top;
+    int bottom;
+  };
+
+  std::vector<GlyphRun>  glyphRuns_;
+  std::vector<LineRange> lines_;
+  bool                   layoutValid_{false};
+
+  // Glyph bitmaps rasterized at the current pixel size (see glyphImage()). Bitmaps are
+  // never modified once shared: an image stays valid as long as its bitmap is kept.
+  struct GlyphImage {
+    IBMFDefs::BitmapConstPtr bitmap;
+    QImage                   image;
+  };
+
+  std::unordered_map<const IBMFDefs::Bitmap *, GlyphImage> glyphImages_;
+
   QString        textToDraw_;
   IBMFFontModPtr font_;
   int            faceIdx_;
@@ -62,11 +100,13 @@ private:
   IBMFDefs::GlyphInfoPtr    bypassGlyphInfo_{nullptr};
   IBMFDefs::GlyphLigKernPtr bypassGlyphLigKern_{nullptr};
 
-  auto computeOpticalKerning(const BitmapPtr b1, const BitmapPtr b2, const GlyphInfoPtr i1,
-                             const GlyphInfoPtr i2) const -> FIX16;
+  auto computeOpticalKerning(const BitmapConstPtr b1, const BitmapConstPtr b2, const GlyphInfo &i1,
+                             const GlyphInfo &i2) const -> FIX16;
   auto computeSize() -> void;
 
-  auto printWord(WordPtr &word, QPainter *painter) -> void;
-  auto printLine(QPainter *painter) -> void;
-  auto addWordToLine(QString &w, QPainter *painter) -> void;
+  auto layout() -> void;
+  auto glyphImage(const IBMFDefs::BitmapConstPtr &bitmap) -> const QImage &;
+  auto layoutWord(WordPtr &word) -> void;
+  auto layoutLine() -> void;
+  auto addWordToLine(QString &w) -> void;
 };
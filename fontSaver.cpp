@@ -0,0 +1,29 @@
+#include "fontSaver.h"
+
+#include <QDataStream>
+#include <QSaveFile>
+#include <QTextStream>
+
+FontSaver::FontSaver(IBMFFontModPtr font, QString filePath, bool maxCompression)
+    : font_(font), filePath_(filePath), maxCompression_(maxCompression) {}
+
+void FontSaver::run() {
+  // QSaveFile writes to a temporary file that replaces filePath_ only once committed. A
+  // failed, canceled or interrupted save leaves the existing file untouched.
+  QSaveFile file(filePath_);
+  if (file.open(QIODevice::WriteOnly)) {
+    QDataStream out(&file);
+    QTextStream logStream(&log_);
+    succeeded_ = font_->save(
+                     out,
+                     [this](int savedFaceCount, int faceCount) {
+                       emit progress(savedFaceCount, faceCount);
+                       return !canceled_;
+                     },
+                     maxCompression_, &logStream) &&
+                 file.commit();
+  }
+  emit finished();
+}
+
+void FontSaver::cancel() { canceled_ = true; }
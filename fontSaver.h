@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+
+#include <QObject>
+#include <QString>
+
+#include "IBMFDriver/IBMFFontMod.hpp"
+
+// Saves a font to a file from a worker thread. The font must not be accessed by anything
+// else during the save: it is expected to be a snapshot (see IBMFFontMod::snapshotOf()).
+class FontSaver : public QObject {
+  Q_OBJECT
+public:
+  FontSaver(IBMFFontModPtr font, QString filePath, bool maxCompression = false);
+
+  inline IBMFFontModPtr font() const { return font_; }
+  inline bool           succeeded() const { return succeeded_; }
+  inline bool           wasCanceled() const { return canceled_ && !succeeded_; }
+  inline const QString &log() const { return log_; }
+
+public slots:
+  void run();
+  void cancel();
+
+signals:
+  void progress(int savedFaceCount, int faceCount);
+  void finished();
+
+private:
+  IBMFFontModPtr    font_;
+  QString           filePath_;
+  bool              maxCompression_;
+  QString           log_;
+  std::atomic<bool> canceled_{false};
+  bool              succeeded_{false};
+};
@@ -30,15 +30,31 @@ FreeType::~FreeType() {
 
 FT_Face FreeType::openFace(QString filename) {
   if (isInitialized()) {
-    FT_Face  ftFace;
-    FT_Error error = FT_New_Face(ftLib_, filename.toStdString().c_str(), 0, &ftFace);
-    if (error) {
+    FT_Face ftFace = openWorkerFace(filename);
+    if (ftFace == nullptr) {
       QMessageBox::warning(nullptr, "Unable to open font",
                            QString("Not able to open font %1").arg(filename));
-      return nullptr;
     }
     return ftFace;
   } else {
     return nullptr;
   }
 }
+
+FT_Face FreeType::openWorkerFace(QString filename) {
+  if (isInitialized()) {
+    std::lock_guard<std::mutex> lock(facesMutex_);
+    FT_Face                     ftFace;
+    FT_Error error = FT_New_Face(ftLib_, filename.toStdString().c_str(), 0, &ftFace);
+    return (error == 0) ? ftFace : nullptr;
+  } else {
+    return nullptr;
+  }
+}
+
+void FreeType::closeFace(FT_Face face) {
+  if (face != nullptr) {
+    std::lock_guard<std::mutex> lock(facesMutex_);
+    FT_Done_Face(face);
+  }
+}
@@ -9,12 +9,15 @@
 #include FT_DRIVER_H
 #include FT_MODULE_H
 
+#include <mutex>
+
 #include <QMessageBox>
 
 class FreeType {
 private:
   bool       initialized_;
   FT_Library ftLib_;
+  std::mutex facesMutex_; // FT_New_Face() and FT_Done_Face() are not thread-safe
 
 public:
   FreeType();
@@ -24,4 +27,9 @@ public:
   inline FT_Library getLib() { return ftLib_; }
 
   FT_Face openFace(QString filename);
+
+  // To be used by worker threads: no message box is shown on error. Each thread must use
+  // its own face.
+  FT_Face openWorkerFace(QString filename);
+  void    closeFace(FT_Face face);
 };
@@ -5,9 +5,12 @@
 
 #include <QColor>
 #include <QDateTime>
+#include <QEventLoop>
+#include <QProgressDialog>
 #include <QRegularExpression>
 #include <QSettings>
 #include <QTextStream>
+#include <QThread>
 
 #include "./ui_mainwindow.h"
 #include "IBMFDriver/IBMFHexImport.hpp"
@@ -15,6 +18,7 @@
 #include "Kerning/kerningDialog.h"
 #include "blocksDialog.h"
 #include "fix16Delegate.h"
+#include "fontSaver.h"
 #include "hexFontParameterDialog.h"
 #include "pasteSelectionCommand.h"
 #include "showResultDialog.h"
@@ -197,6 +201,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
 
   ui->actionSave->setEnabled(false);
   ui->actionSaveBackup->setEnabled(false);
+  ui->actionSaveMaxCompression->setEnabled(false);
   ui->actionProofing_Tool->setEnabled(false);
   ui->menuExport->setEnabled(true);
 
@@ -234,11 +239,12 @@ void MainWindow::updateCharactersList() {
         char32_t codePoint = ibmfFont_->getUTF32(idx);
         if ((codePoint >= 0xE000) && (codePoint <= 0xF8FF)) {
             // These codePoint are specific to the font, uses the IBMF Font glyphs to show on screen
-            IBMFDefs::GlyphInfoPtr glyphInfo;
-            IBMFDefs::BitmapPtr bitmap;
-            if (ibmfFont_->getGlyph(ibmfFaceIdx_, idx, glyphInfo, bitmap, ibmfGlyphLigKern_)) {
+            IBMFDefs::GlyphInfo glyphInfo;
+            IBMFDefs::BitmapConstPtr bitmap;
+            IBMFDefs::GlyphLigKernConstPtr ligKern;
+            if (ibmfFont_->viewGlyph(ibmfFaceIdx_, idx, glyphInfo, bitmap, ligKern)) {
                 auto renderer = new BitmapRenderer(ui->charactersList, 2, true, false);
-                renderer->clearAndLoadBitmap(idx, *bitmap, *ibmfFaceHeader_, *glyphInfo);
+                renderer->clearAndLoadBitmap(idx, *bitmap, *ibmfFaceHeader_, glyphInfo);
                 ui->charactersList->setCellWidget(row, col, renderer);
                 //  QObject::connect(bitmapRenderer_, &BitmapRenderer::keyPressed, this,
                 //                   &MainWindow::rendererKeyPressed);
@@ -453,7 +459,63 @@ void MainWindow::bitmapChanged(const Bitmap &bitmap, const QPoint &originOffsets
   }
 }
 
-bool MainWindow::saveFont(bool askToConfirmName) {
+// Save a font from a worker thread, the user interface staying responsive. The save is done
+// on a snapshot of the font, under a progress dialog allowing to cancel it. The fonts are
+// memory mapped from their files (see IBMFFontMod): the target file is only replaced once
+// the save is completed (see FontSaver). With maxCompression, log receives the bytes saved
+// in each face. canceled is also set when the reason of a failure was already reported.
+// modifiedMeanwhile is set when the font was modified during a successful save: the font
+// then keeps its modifications, still to be saved.
+bool MainWindow::saveInBackground(IBMFFontModPtr font, const QString &filePath, bool &canceled,
+                                  bool &modifiedMeanwhile, bool maxCompression, QString *log) {
+  QProgressDialog progressDialog("Saving " + QFileInfo(filePath).fileName() + "...", "Cancel", 0,
+                                 0, this);
+  // The dialog is shown at once, blocking the edits and a new save from the main window
+  // while the event loop runs for the whole save.
+  progressDialog.setWindowModality(Qt::WindowModal);
+  progressDialog.setMinimumDuration(0);
+  progressDialog.show();
+
+  QThread    thread;
+  QEventLoop loop;
+  FontSaver  saver(IBMFFontMod::snapshotOf(font, filePath), filePath, maxCompression);
+
+  saver.moveToThread(&thread);
+  connect(&thread, &QThread::started, &saver, &FontSaver::run);
+  connect(&saver, &FontSaver::progress, &progressDialog,
+          [&progressDialog](int savedFaceCount, int faceCount) {
+            progressDialog.setMaximum(faceCount);
+            progressDialog.setValue(savedFaceCount);
+          });
+  connect(&progressDialog, &QProgressDialog::canceled, &saver, &FontSaver::cancel,
+          Qt::DirectConnection);
+  connect(&saver, &FontSaver::finished, &loop, &QEventLoop::quit);
+
+  releaseKeyboard();
+  thread.start();
+  loop.exec();
+  thread.quit();
+  thread.wait();
+  grabKeyboard();
+
+  modifiedMeanwhile = saver.succeeded() && !font->snapshotSaved(saver.font(), filePath);
+
+  canceled = saver.wasCanceled();
+  if (log != nullptr) *log = saver.log();
+
+  if (!saver.succeeded() && !canceled && (saver.font()->getLastError() == 8)) {
+    releaseKeyboard();
+    QMessageBox::critical(this, "CRITICAL ERROR",
+                          "Not able to save " + QFileInfo(filePath).fileName() +
+                              "! A face has more than 255 different ligature/kerning programs, "
+                              "or a ligature/kerning table too large for the IBMF format.");
+    grabKeyboard();
+    canceled = true;
+  }
+  return saver.succeeded();
+}
+
+bool MainWindow::saveFont(bool askToConfirmName, bool maxCompression) {
   saveGlyph();
   saveFace();
   QString                   newFilePath;
@@ -485,49 +547,25 @@ bool MainWindow::saveFont(bool askToConfirmName) {
   if (newFilePath.isEmpty()) {
     result = false;
   } else {
-    QFile outFile;
-    outFile.setFileName(newFilePath);
-    if (outFile.open(QIODevice::WriteOnly)) {
-      QDataStream out(&outFile);
-      if (ibmfFont_->save(out)) {
-        currentFilePath_ = newFilePath;
-        adjustRecentsForCurrentFile();
-        fontChanged_ = false;
-        setWindowTitle("IBMF Font Editor - " + currentFilePath_);
-      } else {
-        QMessageBox::critical(
-            this, "CRITICAL ERROR",
-            "Not able to save font! Please ensure that the following path is writeable:\n\n" +
-                newFilePath);
-        result = false;
-      }
-      outFile.close();
-
-      if ((ibmfBackup_ != nullptr) && (ibmfBackup_->isInitialized())) {
-        QFileInfo fi(newFilePath);
-        QString   backupFilePath = fi.absolutePath() + "/" + fi.completeBaseName() + ".ibmf_mods";
-        outFile.setFileName(backupFilePath);
-        if (outFile.open(QIODevice::WriteOnly)) {
-          QDataStream out(&outFile);
-          if (!ibmfBackup_->save(out)) {
-            QMessageBox::critical(this, "CRITICAL ERROR",
-                                  "Not able to save Font Modifications File! Please ensure that "
-                                  "the following path is writeable:\n\n" +
-                                      backupFilePath);
-          }
-          outFile.close();
-        }
-      } else {
-        if (result) {
-          QMessageBox::warning(this, "Warning",
-                               "Font Modifications File not properly managed by this Editor! "
-                               "Unable to save it. The Main Font File has been saved.");
-        } else {
-          QMessageBox::warning(this, "CRITICAL ERROR",
-                               "Font Modifications File not properly managed by this Editor! "
-                               "Unable to save it. THE MAIN FONT FILE WAS NOT SAVED EITHER!!!");
-        }
+    bool    canceled          = false;
+    bool    modifiedMeanwhile = false;
+    QString log;
+    if (saveInBackground(ibmfFont_, newFilePath, canceled, modifiedMeanwhile, maxCompression,
+                         &log)) {
+      currentFilePath_ = newFilePath;
+      adjustRecentsForCurrentFile();
+      fontChanged_ = modifiedMeanwhile;
+      setWindowTitle("IBMF Font Editor - " + currentFilePath_);
+      if (maxCompression) {
+        QString baseName = QFileInfo(newFilePath).baseName();
+        releaseKeyboard();
+        ShowResultDialog *resultDialog =
+            new ShowResultDialog("Maximum compression of font " + baseName, baseName, log);
+        resultDialog->exec();
+        grabKeyboard();
       }
+    } else if (canceled) {
+      return false;
     } else {
       QMessageBox::critical(
           this, "CRITICAL ERROR",
@@ -535,6 +573,29 @@ bool MainWindow::saveFont(bool askToConfirmName) {
               newFilePath);
       result = false;
     }
+
+    if ((ibmfBackup_ != nullptr) && (ibmfBackup_->isInitialized())) {
+      QFileInfo fi(newFilePath);
+      QString   backupFilePath = fi.absolutePath() + "/" + fi.completeBaseName() + ".ibmf_mods";
+      if (!saveInBackground(ibmfBackup_, backupFilePath, canceled, modifiedMeanwhile) &&
+          !canceled) {
+        QMessageBox::critical(this, "CRITICAL ERROR",
+                              "Not able to save Font Modifications File! Please ensure that "
+                              "the following path is writeable:\n\n" +
+                                  backupFilePath);
+      }
+      if (modifiedMeanwhile) fontChanged_ = true;
+    } else {
+      if (result) {
+        QMessageBox::warning(this, "Warning",
+                             "Font Modifications File not properly managed by this Editor! "
+                             "Unable to save it. The Main Font File has been saved.");
+      } else {
+        QMessageBox::warning(this, "CRITICAL ERROR",
+                             "Font Modifications File not properly managed by this Editor! "
+                             "Unable to save it. THE MAIN FONT FILE WAS NOT SAVED EITHER!!!");
+      }
+    }
   }
   return result;
 }
@@ -580,9 +641,8 @@ bool MainWindow::openFont(QString filePath) {
         ui->actionDump_Modif_Content->setEnabled(true);
         ui->actionDump_Modif_Content_With_Glyphs_Bitmap->setEnabled(true);
       } else {
-        QByteArray content = file.readAll();
         file.close();
-        ibmfBackup_ = IBMFFontModPtr(new IBMFFontMod((uint8_t *)content.data(), content.size()));
+        ibmfBackup_ = IBMFFontModPtr(new IBMFFontMod(backupFilePath));
         if (ibmfBackup_->isInitialized()) {
           if (ibmfBackup_->getFontFormat() == FontFormat::BACKUP) {
             ui->actionDump_Modif_Content->setEnabled(true);
@@ -613,10 +673,9 @@ bool MainWindow::openFont(QString filePath) {
 }
 
 bool MainWindow::loadFont(QFile &file) {
-  QByteArray content = file.readAll();
   file.close();
   clearAll();
-  ibmfFont_ = IBMFFontModPtr(new IBMFFontMod((uint8_t *)content.data(), content.size()));
+  ibmfFont_ = IBMFFontModPtr(new IBMFFontMod(file.fileName()));
   if (ibmfFont_->isInitialized()) {
     ibmfPreamble_ = ibmfFont_->getPreamble();
 
@@ -645,6 +704,7 @@ bool MainWindow::loadFont(QFile &file) {
 
     ui->actionSave->setEnabled(true);
     ui->actionSaveBackup->setEnabled(true);
+    ui->actionSaveMaxCompression->setEnabled(true);
     ui->actionProofing_Tool->setEnabled(true);
     ui->menuExport->setEnabled(true);
 
@@ -776,6 +836,8 @@ void MainWindow::saveFace() {
 
     ibmfFont_->saveFaceHeader(ibmfFaceIdx_, face_header);
     faceChanged_ = false;
+    // The line height and space size of the proofing text may have changed
+    drawingSpace_->glyphsChanged();
   }
 }
 
@@ -860,7 +922,7 @@ void MainWindow::saveGlyph() {
     }
   }
 
-  drawingSpace_->repaint();
+  drawingSpace_->glyphsChanged();
 }
 
 void MainWindow::populateKernTable() {
@@ -1245,6 +1307,8 @@ void MainWindow::on_actionSave_triggered() { saveFont(true); }
 
 void MainWindow::on_actionSaveBackup_triggered() { saveFont(false); }
 
+void MainWindow::on_actionSaveMaxCompression_triggered() { saveFont(true, true); }
+
 void MainWindow::on_clearRecentList_triggered() {
   QSettings   settings("ibmf", "IBMFEditor");
   QStringList recentFilePaths = QStringList();
@@ -1314,7 +1378,7 @@ void MainWindow::on_editKerningButton_clicked() {
     model->save(ibmfGlyphLigKern_->kernSteps);
     populateKernTable();
     ui->kernTable->update();
-    drawingSpace_->update();
+    drawingSpace_->glyphsChanged();
     glyphChanged_ = true;
   }
 }
@@ -1647,10 +1711,8 @@ void MainWindow::on_actionImport_Modifications_File_triggered() {
         QMessageBox::warning(this, "Warning",
                              "Unable to open IBMF Modifications File " + inFilePath);
       } else {
-        QByteArray content = file.readAll();
         file.close();
-        auto fromBackup =
-            IBMFFontModPtr(new IBMFFontMod((uint8_t *)content.data(), content.size()));
+        auto fromBackup = IBMFFontModPtr(new IBMFFontMod(inFilePath));
         if (fromBackup->isInitialized()) {
           if (fromBackup->getFontFormat() == FontFormat::BACKUP) {
             QTextStream resultStream(&result);
@@ -1703,9 +1765,8 @@ void MainWindow::on_actionBuild_Modifications_File_triggered() {
       if (!file.open(QIODevice::ReadOnly)) {
         QMessageBox::warning(this, "Warning", "Unable to open IBMF Font File " + inFilePath);
       } else {
-        QByteArray content = file.readAll();
         file.close();
-        auto fromFont = IBMFFontModPtr(new IBMFFontMod((uint8_t *)content.data(), content.size()));
+        auto fromFont = IBMFFontModPtr(new IBMFFontMod(inFilePath));
         if (fromFont->isInitialized()) {
           if (fromFont->getFontFormat() == FontFormat::UTF32) {
             QTextStream resultStream(&result);
@@ -1768,6 +1829,7 @@ void MainWindow::on_actionRecompute_Ligatures_triggered()
     ibmfFont_->recomputeLigatures();
     fontChanged_ = true;
     updateCharactersList();
+    drawingSpace_->glyphsChanged();
 
     QMessageBox::information(
         this, "Ligatures Recompute Completed", "Ligatures Recompute Completed");
@@ -61,6 +61,7 @@ private slots:
   // void on_actionRLE_Encoder_triggered();
   void on_actionSave_triggered();
   void on_actionSaveBackup_triggered();
+  void on_actionSaveMaxCompression_triggered();
   void on_clearRecentList_triggered();
   void bitmapChanged(const Bitmap &bitmap, const QPoint &originOffsets);
   void setScrollBarSizes(int value);
@@ -144,7 +145,10 @@ private slots:
   void     updateRecentActionList();
   void     adjustRecentsForCurrentFile();
   bool     checkFontChanged();
-  bool     saveFont(bool askToConfirmName);
+  bool     saveFont(bool askToConfirmName, bool maxCompression = false);
+  bool     saveInBackground(IBMFFontModPtr font, const QString &filePath, bool &canceled,
+                            bool &modifiedMeanwhile, bool maxCompression = false,
+                            QString *log = nullptr);
   void     newFontLoaded(QString filePath);
   bool     openFont(QString filePath);
   bool     loadFont(QFile &file);